@@ -0,0 +1,43 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <core/opening_book.h>
+#include <core/opening_book_builder.h>
+
+using ultimate_tictactoe::OpeningBook;
+using ultimate_tictactoe::OpeningBookBuilder;
+using ultimate_tictactoe::OpeningBookEntry;
+
+// Builds an opening book file for the game to use (see OpeningBook).
+//
+// Usage: ultimate-tictactoe-book-builder <output path> [plies] [search depth] [threads]
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <output path> [plies = 4] [search depth = 8] [threads = all cores]"
+              << std::endl;
+    return 1;
+  }
+
+  std::string path = argv[1];
+  size_t num_plies = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4);
+  size_t search_depth = (argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8);
+  size_t num_threads = (argc > 4 ? std::strtoul(argv[4], nullptr, 10) : std::thread::hardware_concurrency());
+  if (num_threads == 0) {
+    num_threads = 1;
+  }
+
+  try {
+    OpeningBookBuilder builder(num_plies, search_depth, num_threads);
+    std::cout << "Searching the first " << num_plies << " plies to depth " << search_depth << " on " << num_threads
+              << " threads" << std::endl;
+    std::vector<OpeningBookEntry> entries = builder.Build(&std::cout);
+    OpeningBook::Write(path, entries);
+    std::cout << "Wrote " << entries.size() << " positions to " << path << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/pattern_evaluator.h>
+#include <core/pattern_trainer.h>
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::PatternEvaluator;
+using ultimate_tictactoe::PatternTrainer;
+
+namespace {
+
+// The seed of the games' random opening moves.
+constexpr uint64_t kSeed = 1;
+
+// The random opening moves of each game, the regularization, and the number of iterations of
+// the fit (see PatternTrainer).
+constexpr size_t kNumRandomPlies = 8;
+constexpr double kRegularization = 1;
+constexpr size_t kNumIterations = 200;
+
+}  // namespace
+
+// Plays games of the AI against itself, fits the weights of the pattern evaluator to them, and
+// writes the weights to a file for the game to use (see PatternEvaluator and
+// UltimateTicTacToeApp::kAIEvaluator).
+//
+// Usage: ultimate-tictactoe-pattern-trainer <output path> [games] [search depth] [threads]
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <output path> [games = 2000] [search depth = 4] [threads = all cores]"
+              << std::endl;
+    return 1;
+  }
+
+  std::string path = argv[1];
+  size_t num_games = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000);
+  size_t search_depth = (argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4);
+  size_t num_threads = (argc > 4 ? std::strtoul(argv[4], nullptr, 10) : std::thread::hardware_concurrency());
+  if (num_threads == 0) {
+    num_threads = 1;
+  }
+
+  try {
+    PatternTrainer trainer(search_depth, kNumRandomPlies, num_threads);
+    std::cout << "Playing " << num_games << " games at depth " << search_depth << " on " << num_threads
+              << " threads" << std::endl;
+    std::vector<std::vector<Action>> games = trainer.PlayGames(num_games, kSeed, &std::cout);
+    for (const std::vector<Action>& game : games) {
+      trainer.AddGame(game);
+    }
+
+    std::vector<float> weights = trainer.Fit(kRegularization, kNumIterations);
+    std::cout << "Fitted " << trainer.GetNumPositions() << " positions with a mean squared error of "
+              << trainer.GetMeanSquaredError(weights) << std::endl;
+    PatternEvaluator::Write(path, weights);
+    std::cout << "Wrote the weights to " << path << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
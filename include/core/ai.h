@@ -1,32 +1,106 @@
 #pragma once
 
+#include <atomic>
+#include <future>
+#include <mutex>
+
 #include <core/superboard.h>
 #include <core/action.h>
 
 namespace ultimate_tictactoe {
 
-// Stores a board state that should match the state of the displayed game, and 
+// Stores a board state that should match the state of the displayed game, and
 // contains the logic for finding the best move. The reason for storing a separate
 // board state is to allow the AI to manipulate the game state during its search
-// without modifying the state of the displayed game (which might otherwise be 
+// without modifying the state of the displayed game (which might otherwise be
 // visible to the user).
+//
+// Moves can be found either by calling GetMove, which blocks until the search is done,
+// or asynchronously: StartSearch searches on a background thread, which can be polled
+// with IsSearchDone and GetBestMoveSoFar, stopped early with RequestStop, and whose
+// result is retrieved with FinishSearch. While a search is running, the background
+// thread uses the stored state, so only the asynchronous methods may be called (the
+// methods that change the state, like UpdateState, cancel the search first).
 class AI {
  public:
+  AI();
+
+  // Cancels the search, if one is running. Derived classes that override
+  // SearchInBackground must also call CancelSearch in their destructors, since the
+  // background thread may otherwise still be using the derived part of the object.
+  virtual ~AI();
+
   // Retrieves the best move as determined by the AI, given the current state of the AI.
   // This method manipulates the state of the game stored by the AI, but ultimately returns it
   // to its original state, but it cannot be marked as const. If not overriden by a
   // derived class, this plays the most top-left move possible (guaranteed to be valid
   // in the state that the AI holds).
   virtual Action GetMove();
-  
-  // Updates the state with the given action.
-  void UpdateState(Action a);
-  
+
+  // Updates the state with the given action. Derived classes that keep information
+  // about the current state (e.g. from searching in the background) can override this
+  // to update it, but must still call this method.
+  virtual void UpdateState(Action a);
+
   // Resets the state of the game stored by the AI.
-  void ResetState();
-  
+  virtual void ResetState();
+
+  // Replaces the state of the game stored by the AI with the given state.
+  virtual void SetState(const SuperBoard& state);
+
+  // Starts searching for the best move on a background thread (cancelling any search that
+  // is already running), and returns a future that will hold the move. Any exception thrown
+  // by the search (e.g. because the game is complete) is stored in the future, and is
+  // rethrown by FinishSearch.
+  virtual std::shared_future<Action> StartSearch();
+
+  // Returns true iff a search has been started, and its result has not yet been retrieved
+  // by FinishSearch or discarded by CancelSearch.
+  bool IsSearching() const;
+
+  // Returns true iff the search has finished (or no search is running), so that
+  // FinishSearch will not block.
+  bool IsSearchDone() const;
+
+  // Asks the search to stop as soon as possible. The search then finishes with the best
+  // move found so far. Does not block; use FinishSearch to retrieve the move. Thread safe.
+  void RequestStop();
+
+  // Clears a stop requested with RequestStop. StartSearch does this itself, so this is only
+  // needed by callers that run the AI's search methods on threads of their own.
+  void ClearStopRequest();
+
+  // Returns the best move that the running (or finished) search has found so far. Throws
+  // a runtime_error exception if no move has been found yet.
+  Action GetBestMoveSoFar() const;
+
+  // Waits for the search to finish, and returns its result. Throws a logic_error exception
+  // if no search has been started.
+  Action FinishSearch();
+
+  // Stops the search if one is running, and waits for it to finish, discarding its result.
+  void CancelSearch();
+
  protected:
   SuperBoard state_;
+
+  // Set when the running search should stop. Searches should check this regularly.
+  std::atomic<bool> stop_requested_;
+
+  // Runs on the background thread started by StartSearch, and returns the best move.
+  // It should report its progress with SetBestMoveSoFar, and return early when
+  // stop_requested_ is set. If not overriden, this calls GetMove, so the search
+  // cannot be stopped early.
+  virtual Action SearchInBackground();
+
+  // Records the best move found so far by the running search. Thread safe.
+  void SetBestMoveSoFar(Action a);
+
+ private:
+  std::shared_future<Action> search_;
+  mutable std::mutex best_move_so_far_mutex_;
+  bool has_best_move_so_far_;
+  Action best_move_so_far_;
 };
 
-}  // namespace ultimate_tictactoe
\ No newline at end of file
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+
+#include <core/analysis_line.h>
+#include <core/bitboard.h>
+#include <core/proof_number_search.h>
+#include <core/spsc_channel.h>
+#include <core/superboard.h>
+#include <core/tree_search_ai.h>
+
+namespace ultimate_tictactoe {
+
+// The result of one iteration of the analysis engine's search.
+struct AnalysisInfo {
+  // Identifies the position that was analyzed (see AnalysisEngine::SetPosition).
+  size_t position_id;
+
+  size_t depth;
+
+  // The best lines found, sorted from best to worst. Values are for the player to move.
+  vector<AnalysisLine> lines;
+
+  // Whether the player to move can force a win, as far as the proof search has found out, and
+  // if so, the first move of the proof.
+  ProofResult forced_win;
+  Action forced_win_move;
+
+  size_t nodes;
+  double nodes_per_second;
+};
+
+// Analyzes a position on a background thread for as long as it is running: the
+// position is searched with iterative deepening (using TreeSearchAI's multi-PV search,
+// with endgames solved exactly), and the result of each depth is published as an
+// AnalysisInfo. Before each depth, a proof-number search with a budget of
+// kProofSearchNodesPerDepth nodes tries to find out whether the player to move can force a
+// win; since it keeps its table, each one continues where the last left off. When the
+// position is changed, the current search is abandoned, and the analysis restarts from depth 1.
+//
+// The newest analysis of every position is cached by the position's hash, so returning to
+// a position that has already been analyzed (e.g. after a reset) reports the cached result
+// immediately, and the search continues from the depth after it rather than from depth 1.
+//
+// All communication with the background thread goes through lock-free channels, so
+// neither the thread calling SetPosition and PollAnalysis (e.g. the render loop) nor
+// the background thread ever waits for the other. Start, Stop, SetPosition, and
+// PollAnalysis must all be called from the same thread.
+class AnalysisEngine {
+ public:
+  // Searching deeper than the longest possible game is pointless.
+  static constexpr size_t kMaxDepth = 81;
+
+  // Passing this as the number of lines analyzes every valid move.
+  static constexpr size_t kAllLines = BitBoard::kNumCells * BitBoard::kNumCells;
+
+  // The cache is cleared when it reaches this many positions.
+  static constexpr size_t kMaxCachedPositions = 4096;
+
+  static constexpr size_t kProofSearchNodesPerDepth = TreeSearchAI::kSuggestedProofSearchNodes;
+
+  explicit AnalysisEngine(size_t num_lines = 3);
+
+  // Stops the background thread, if it is running.
+  ~AnalysisEngine();
+
+  // Starts the background thread, if it is not already running. It analyzes the latest
+  // position set with SetPosition (and idles until one is set).
+  void Start();
+
+  // Stops the background thread and waits for it to exit.
+  void Stop();
+
+  bool IsRunning() const;
+
+  // Sets the position to analyze, and returns its ID, which identifies the AnalysisInfo
+  // objects produced for it. IDs increase with every call.
+  size_t SetPosition(const SuperBoard& board);
+
+  // Sets the number of lines analyzed for the positions set after this call.
+  void SetNumLines(size_t num_lines);
+
+  // Retrieves the newest AnalysisInfo published since the last call, discarding older ones,
+  // and ones for positions other than the latest. Returns false if there is nothing new.
+  // Right after SetPosition, this returns the cached analysis of the position, if there is one.
+  bool PollAnalysis(AnalysisInfo& analysis);
+
+ private:
+  static constexpr size_t kPositionChannelCapacity = 4;
+  static constexpr size_t kAnalysisChannelCapacity = 16;
+
+  // How long the background thread sleeps while it has nothing to analyze.
+  const std::chrono::milliseconds kIdleSleepTime = std::chrono::milliseconds(5);
+
+  struct Position {
+    size_t id;
+    SuperBoard board;
+    size_t num_lines;
+
+    // The depth of the cached analysis that the search continues from, or 0 if there is none.
+    size_t completed_depth;
+  };
+
+  size_t num_lines_;
+
+  // Only used by the background thread, except for RequestStop.
+  TreeSearchAI ai_;
+  ProofNumberSearch proof_number_search_;
+  std::thread thread_;
+  std::atomic<bool> stop_requested_;
+  std::atomic<bool> position_changed_;
+
+  SpscChannel<Position, kPositionChannelCapacity> positions_;
+  SpscChannel<AnalysisInfo, kAnalysisChannelCapacity> analyses_;
+
+  // If the position channel is full when SetPosition is called, the position is kept here
+  // and sent on a later call to SetPosition or PollAnalysis.
+  size_t latest_position_id_;
+  bool has_pending_position_;
+  Position pending_position_;
+
+  // Only used by the thread calling SetPosition and PollAnalysis. The cached analysis of the
+  // latest position is reported by the next call to PollAnalysis iff has_new_analysis_ is set.
+  std::unordered_map<uint64_t, AnalysisInfo> analysis_cache_;
+  uint64_t latest_position_hash_;
+  size_t latest_num_lines_needed_;
+  bool has_new_analysis_;
+
+  // Tries to send the pending position to the background thread.
+  void SendPendingPosition();
+
+  // Returns true iff the cached analysis of the latest position has enough lines to be
+  // reported for it (it may have been made when fewer lines were being analyzed).
+  bool IsCachedAnalysisUsable(const AnalysisInfo& analysis) const;
+
+  // Runs on the background thread.
+  void Run();
+};
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+#include <core/action.h>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+// A candidate move found by analyzing a position, together with its value (for the
+// player to move) and its principal variation: the sequence of moves, starting with
+// the candidate move itself, that the search expects both players to play.
+struct AnalysisLine {
+  Action action;
+  double value;
+  vector<Action> principal_variation;
+};
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <core/bitboard.h>
+#include <core/random_playout.h>
+#include <core/superboard.h>
+
+namespace ultimate_tictactoe {
+
+// Aggregated outcomes of a set of playouts, taken with respect to the player to
+// move in the position the playouts started from.
+struct PlayoutCounts {
+  size_t wins;
+  size_t draws;
+  size_t losses;
+};
+
+// Runs random playouts kLanes at a time, using a bit-sliced board: every bit of
+// board state (e.g. "Player 1 has played on cell 4 of sub-board 2") is stored as a
+// 64-bit word, where bit i of the word holds that piece of state for game (lane) i.
+// All lanes therefore advance one move per step using only bitwise logic, including
+// sub-board and game win detection, and lanes are masked out as their games finish.
+//
+// Every lane plays an independent, uniformly random valid move, matching the
+// distribution of RandomPlayout. See PlayRandomMoves for how moves are chosen.
+class BatchPlayout {
+ public:
+  static constexpr size_t kLanes = 64;
+
+  explicit BatchPlayout(uint64_t seed = RandomPlayout::kDefaultSeed);
+
+  // Plays num_playouts random games from the given position (in batches of kLanes)
+  // and returns the aggregated outcomes. The counts always sum to num_playouts.
+  PlayoutCounts Play(const BitBoard& board, size_t num_playouts);
+  PlayoutCounts Play(const SuperBoard& board, size_t num_playouts);
+
+ private:
+  static constexpr size_t kNumCells = BitBoard::kNumCells;
+
+  // Bit-sliced board state for the current batch. Note that the active player is
+  // shared by all lanes, since all lanes start from the same position and every
+  // active lane plays exactly one move per step.
+  uint64_t marks_[2][kNumCells][kNumCells];
+  uint64_t won_sub_boards_[2][kNumCells];
+  uint64_t complete_sub_boards_[kNumCells];
+  uint64_t required_sub_board_[kNumCells];
+  uint64_t active_lanes_;
+  size_t current_player_;
+
+  XorShiftRandom random_;
+
+  // Broadcasts the given position to the lanes set in active_lanes.
+  void LoadPosition(const BitBoard& board, uint64_t active_lanes);
+
+  // Plays a single random move in every active lane.
+  void PlayRandomMoves();
+
+  // Masks out the lanes whose games just finished, and adds their outcomes to
+  // counts (with respect to starting_player).
+  void RetireFinishedLanes(size_t starting_player, PlayoutCounts& counts);
+};
+
+}  // namespace ultimate_tictactoe
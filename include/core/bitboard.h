@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <core/action.h>
+#include <core/player.h>
+#include <core/win_state.h>
+#include <core/superboard.h>
+
+namespace ultimate_tictactoe {
+
+// Returns the number of set bits in the mask.
+size_t PopCount(uint32_t mask);
+
+// Returns the index of the n-th (0-indexed, counting from the least significant
+// bit) set bit in the mask. Behavior is undefined if the mask has n or fewer set bits.
+size_t SelectNthSetBit(uint32_t mask, size_t n);
+
+// A compact, allocation-free copy of an Ultimate TTT position, intended for hot
+// loops (e.g. random playouts) where SuperBoard's validation, exceptions, and move
+// history bookkeeping are too expensive. SuperBoard remains the authoritative game
+// state; a BitBoard is typically constructed from one and then played forward.
+//
+// Sub-boards and the cells inside a sub-board are both indexed row-major, i.e.
+// index = row * kBoardSize + col. Each sub-board is stored as one 9-bit mask per
+// player, where bit i is set iff that player has played on cell i. Only works for
+// kBoardSize = 3 boards.
+class BitBoard {
+ public:
+  static constexpr size_t kBoardSize = SuperBoard::kBoardSize;
+  static constexpr size_t kNumCells = kBoardSize * kBoardSize;
+  static constexpr uint16_t kFullMask = (1 << kNumCells) - 1;
+
+  // Value of GetRequiredSubBoard() when the active player may play on any
+  // sub-board that is not complete.
+  static constexpr size_t kNoRequiredSubBoard = kNumCells;
+
+  // The number of symmetries of the board (the rotations and reflections of a square).
+  // Symmetry 0 is the identity.
+  static constexpr size_t kNumSymmetries = 8;
+
+  // The masks of the lines (rows, columns, and diagonals) of a 3x3 grid, both of the cells in a
+  // sub-board and of the sub-boards in the board.
+  static constexpr size_t kNumLines = 8;
+  static constexpr uint16_t kLineMasks[kNumLines] = {0007, 0070, 0700,   // Rows
+                                                     0111, 0222, 0444,   // Columns
+                                                     0421, 0124};        // Diagonals
+
+  // Initializes an empty board, with Player 1 to move.
+  BitBoard();
+
+  // Copies the position (marks, required sub-board, and active player) of the given board.
+  explicit BitBoard(const SuperBoard& board);
+
+  // Plays the active player's mark on the given cell of the given sub-board and
+  // passes the turn. The move is not validated; behavior is undefined unless the
+  // cell is set in GetValidCellMask(sub_board).
+  void PlayMove(size_t sub_board, size_t cell);
+
+  // Returns the mask of cells that the active player may play on in the given
+  // sub-board. This is 0 if the game is complete, the sub-board is complete, or
+  // a different sub-board is required.
+  uint16_t GetValidCellMask(size_t sub_board) const;
+
+  // Returns the total number of valid moves for the active player.
+  size_t CountValidMoves() const;
+
+  // Returns the valid move with the given index, counting the valid moves by sub-board and then
+  // by cell from 0 (e.g. for choosing a move uniformly at random). Behavior is undefined unless
+  // n < CountValidMoves().
+  Action GetNthValidMove(size_t n) const;
+
+  // Returns the number of empty cells in the sub-boards that are not complete, i.e. the
+  // cells that may still be played on in the rest of the game.
+  size_t CountOpenCells() const;
+
+  // Same semantics as Board<T>::GetWinner, applied to the whole game.
+  WinState GetWinner() const;
+  bool IsComplete() const;
+
+  // Same semantics as SuperBoard::IsDeadDraw.
+  bool IsDeadDraw() const;
+
+  Player GetCurrentPlayer() const;
+
+  // Returns the sub-board that must be played on, or kNoRequiredSubBoard if any
+  // sub-board that is not complete may be played on.
+  size_t GetRequiredSubBoard() const;
+
+  // Returns the mask of cells in the given sub-board that the given player has played on.
+  uint16_t GetMarks(Player player, size_t sub_board) const;
+
+  // Returns the mask of sub-boards won by the given player.
+  uint16_t GetWonSubBoards(Player player) const;
+
+  // Returns the mask of sub-boards that are complete (won or tied).
+  uint16_t GetCompleteSubBoards() const;
+
+  // Returns the mask of sub-boards that would win the game for the given player if they won
+  // them (sub-boards that are complete are never included).
+  uint16_t GetGameWinningSubBoards(Player player) const;
+
+  // If the active player can win the game with this move, sets sub_board and cell to such a
+  // move and returns true. This takes constant time (a lookup per sub-board at most), so it
+  // can be checked at every node of a search.
+  bool FindWinningMove(size_t& sub_board, size_t& cell) const;
+
+  // Returns a Zobrist hash of the position (marks, required sub-board, and active player),
+  // which is updated incrementally by PlayMove. Equal positions have equal hashes, however
+  // they were reached.
+  uint64_t GetHash() const;
+
+  // Returns the position transformed by the given symmetry, which is applied both to the
+  // sub-boards and to the cells inside each sub-board. This preserves the rules (the cell
+  // played on still determines the next sub-board), so the transformed position is
+  // equivalent to this one, with every move transformed the same way.
+  BitBoard GetTransformed(size_t symmetry) const;
+
+  // Returns the symmetry that transforms this position into its canonical form: the one of
+  // its transformed positions with the smallest hash (the first such symmetry, if several
+  // give the same position).
+  size_t GetCanonicalSymmetry() const;
+
+  // Returns the hash of the canonical form of the position, which is the same for all
+  // positions that are equivalent by symmetry.
+  uint64_t GetCanonicalHash() const;
+
+  // Returns the mask of symmetries (bit i for symmetry i) that transform the position into
+  // itself, which always includes the identity. Moves that one of these symmetries transforms
+  // into each other lead to equivalent positions, so only one of them needs to be searched.
+  uint8_t GetStabilizerSymmetries() const;
+
+  // Returns true iff the mask contains all three cells of some row, column, or diagonal.
+  static bool IsWinningMask(uint16_t mask);
+
+  // Returns the mask of cells in neither of the given masks that would complete a row,
+  // column, or diagonal for the player with the given marks, i.e. the cells where that
+  // player threatens to win. This works for the cells of a sub-board, and for the
+  // sub-boards of the whole board (with the player's won sub-boards as the marks, and the
+  // other complete sub-boards as the other marks).
+  static uint16_t GetWinningCells(uint16_t marks, uint16_t other_marks);
+
+  // Conversions between Actions and (sub-board, cell) indices.
+  static Action ToAction(size_t sub_board, size_t cell);
+  static size_t SubBoardIndex(const Action& a);
+  static size_t CellIndex(const Action& a);
+
+  // Returns the index (of a sub-board, or of a cell inside a sub-board) that the given
+  // symmetry moves the given index to, and the symmetry that undoes the given symmetry.
+  static size_t TransformIndex(size_t symmetry, size_t index);
+  static size_t InverseSymmetry(size_t symmetry);
+
+  // Transforms the action by the given symmetry, as described in GetTransformed.
+  static Action TransformAction(size_t symmetry, const Action& a);
+
+ private:
+  uint16_t marks_[2][kNumCells];
+  uint16_t won_sub_boards_[2];
+  uint16_t complete_sub_boards_;
+  uint8_t required_sub_board_;
+  uint8_t current_player_;
+  uint64_t hash_;
+
+  // winning_masks_[mask] is true iff IsWinningMask(mask).
+  static const bool* const winning_masks_;
+
+  // winning_cells_[marks * (kFullMask + 1) + other_marks] is GetWinningCells(marks, other_marks).
+  static const uint16_t* const winning_cells_;
+
+  // Random keys for the Zobrist hash: one per player per (sub-board, cell), at index
+  // (player * kNumCells + sub_board) * kNumCells + cell, followed by one per value of
+  // required_sub_board_ (including kNoRequiredSubBoard), followed by one for Player 2 to move.
+  static const uint64_t* const zobrist_keys_;
+  static constexpr size_t kZobristRequiredSubBoardOffset = 2 * kNumCells * kNumCells;
+  static constexpr size_t kZobristPlayer2Offset = kZobristRequiredSubBoardOffset + kNumCells + 1;
+
+  // Computes the hash of the position from scratch.
+  uint64_t ComputeHash() const;
+
+  // Returns the mask with each bit moved to the index that the given symmetry moves it to.
+  static uint16_t TransformMask(size_t symmetry, uint16_t mask);
+};
+
+}  // namespace ultimate_tictactoe
+
+// Inline definitions for the methods used in hot loops
+#include <core/bitboard.hpp>
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <core/bitboard.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ultimate_tictactoe {
+
+inline size_t PopCount(uint32_t mask) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_popcount(mask));
+#elif defined(_MSC_VER)
+  return static_cast<size_t>(__popcnt(mask));
+#else
+  size_t count = 0;
+  for (; mask != 0; mask &= mask - 1) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+inline size_t SelectNthSetBit(uint32_t mask, size_t n) {
+  // Clear the n lowest set bits, then find the lowest remaining one.
+  for (; n > 0; n--) {
+    mask &= mask - 1;
+  }
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<size_t>(index);
+#else
+  size_t index = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+inline void BitBoard::PlayMove(size_t sub_board, size_t cell) {
+  uint16_t& marks = marks_[current_player_][sub_board];
+  marks |= static_cast<uint16_t>(1 << cell);
+  hash_ ^= zobrist_keys_[(current_player_ * kNumCells + sub_board) * kNumCells + cell] ^
+           zobrist_keys_[kZobristRequiredSubBoardOffset + required_sub_board_] ^
+           zobrist_keys_[kZobristPlayer2Offset];
+
+  if (winning_masks_[marks]) {
+    won_sub_boards_[current_player_] |= static_cast<uint16_t>(1 << sub_board);
+    complete_sub_boards_ |= static_cast<uint16_t>(1 << sub_board);
+  } else if ((marks | marks_[1 - current_player_][sub_board]) == kFullMask) {
+    complete_sub_boards_ |= static_cast<uint16_t>(1 << sub_board);
+  }
+
+  // Same rule as SuperBoard: the cell played on determines the next sub-board,
+  // unless that sub-board is complete.
+  if (complete_sub_boards_ & (1 << cell)) {
+    required_sub_board_ = static_cast<uint8_t>(kNoRequiredSubBoard);
+  } else {
+    required_sub_board_ = static_cast<uint8_t>(cell);
+  }
+  hash_ ^= zobrist_keys_[kZobristRequiredSubBoardOffset + required_sub_board_];
+  current_player_ = static_cast<uint8_t>(1 - current_player_);
+}
+
+inline uint16_t BitBoard::GetValidCellMask(size_t sub_board) const {
+  if ((required_sub_board_ != kNoRequiredSubBoard && required_sub_board_ != sub_board) ||
+      (complete_sub_boards_ & (1 << sub_board)) || IsComplete()) {
+    return 0;
+  }
+  return static_cast<uint16_t>(~(marks_[0][sub_board] | marks_[1][sub_board]) & kFullMask);
+}
+
+inline WinState BitBoard::GetWinner() const {
+  if (winning_masks_[won_sub_boards_[0]]) {
+    return WinState::kPlayer1Win;
+  } else if (winning_masks_[won_sub_boards_[1]]) {
+    return WinState::kPlayer2Win;
+  } else if (complete_sub_boards_ == kFullMask) {
+    return WinState::kTie;
+  } else {
+    return WinState::kInProgress;
+  }
+}
+
+inline bool BitBoard::IsComplete() const {
+  return winning_masks_[won_sub_boards_[0]] || winning_masks_[won_sub_boards_[1]] ||
+         complete_sub_boards_ == kFullMask;
+}
+
+inline bool BitBoard::IsDeadDraw() const {
+  // A player can still win iff the sub-boards that are not tied or won by the opponent contain a line.
+  uint16_t tied_sub_boards = complete_sub_boards_ & ~(won_sub_boards_[0] | won_sub_boards_[1]);
+  return !winning_masks_[~(won_sub_boards_[1] | tied_sub_boards) & kFullMask] &&
+         !winning_masks_[~(won_sub_boards_[0] | tied_sub_boards) & kFullMask];
+}
+
+inline Player BitBoard::GetCurrentPlayer() const {
+  return current_player_ == 0 ? Player::kPlayer1 : Player::kPlayer2;
+}
+
+inline size_t BitBoard::GetRequiredSubBoard() const {
+  return required_sub_board_;
+}
+
+inline uint16_t BitBoard::GetMarks(Player player, size_t sub_board) const {
+  return marks_[player == Player::kPlayer1 ? 0 : 1][sub_board];
+}
+
+inline uint16_t BitBoard::GetWonSubBoards(Player player) const {
+  return won_sub_boards_[player == Player::kPlayer1 ? 0 : 1];
+}
+
+inline uint16_t BitBoard::GetCompleteSubBoards() const {
+  return complete_sub_boards_;
+}
+
+inline uint64_t BitBoard::GetHash() const {
+  return hash_;
+}
+
+inline bool BitBoard::IsWinningMask(uint16_t mask) {
+  return winning_masks_[mask & kFullMask];
+}
+
+inline uint16_t BitBoard::GetWinningCells(uint16_t marks, uint16_t other_marks) {
+  return winning_cells_[(marks & kFullMask) * (kFullMask + 1) + (other_marks & kFullMask)];
+}
+
+inline uint16_t BitBoard::GetGameWinningSubBoards(Player player) const {
+  size_t player_index = (player == Player::kPlayer1 ? 0 : 1);
+  return GetWinningCells(won_sub_boards_[player_index], complete_sub_boards_ & ~won_sub_boards_[player_index]);
+}
+
+inline bool BitBoard::FindWinningMove(size_t& sub_board, size_t& cell) const {
+  if (IsComplete()) {
+    return false;
+  }
+  uint16_t playable_sub_boards = (required_sub_board_ == kNoRequiredSubBoard
+                                      ? static_cast<uint16_t>(~complete_sub_boards_ & kFullMask)
+                                      : static_cast<uint16_t>(1 << required_sub_board_));
+  uint16_t candidates = playable_sub_boards & GetGameWinningSubBoards(GetCurrentPlayer());
+  for (; candidates != 0; candidates &= candidates - 1) {
+    size_t candidate = SelectNthSetBit(candidates, 0);
+    uint16_t winning_cells = GetWinningCells(marks_[current_player_][candidate],
+                                             marks_[1 - current_player_][candidate]);
+    if (winning_cells != 0) {
+      sub_board = candidate;
+      cell = SelectNthSetBit(winning_cells, 0);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <core/action.h>
+#include <core/bitboard.h>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+// The proven result of a position, for the player to move.
+struct EndgameSolution {
+  // 1 if the player to move wins, -1 if they lose, and 0 if the game is a draw.
+  int outcome;
+
+  // The number of plies until the game ends, when the winner wins as quickly as possible and
+  // the loser loses as slowly as possible. Draws are not told apart by length, so this is 0
+  // for them.
+  size_t distance_to_end;
+
+  // The first move of such a line.
+  Action best_move;
+};
+
+// Solves positions exactly, rather than estimating them: the game tree is searched to the end,
+// with alpha-beta pruning over the scores win, draw, and loss (wins and losses are scored by
+// their distance, so faster wins are preferred). Intended for endgames, where few cells are
+// left to play on; the search works on BitBoards, and remembers solved positions in a hash
+// table so that transpositions are only solved once.
+//
+// Since the tree can still be too large in positions with many open cells, each call to Solve
+// has a node budget, and gives up when it runs out.
+class EndgameSolver {
+ public:
+  static constexpr size_t kDefaultTableSizeLog2 = 18;
+  static constexpr size_t kDefaultMaxNodes = 1000000;
+
+  // The table has 2^table_size_log2 entries (of 16 bytes each), and is allocated on the
+  // first call to Solve.
+  explicit EndgameSolver(size_t table_size_log2 = kDefaultTableSizeLog2, size_t max_nodes = kDefaultMaxNodes);
+
+  // Solves the given position, and returns true iff it was solved within the node budget, in
+  // which case solution is set to the result. Throws a runtime_error exception if the game is
+  // complete.
+  bool Solve(const BitBoard& board, EndgameSolution& solution);
+
+  // Returns the number of nodes searched by the last call to Solve.
+  size_t GetNodesSearched() const;
+
+  // Discards all positions remembered in the table (in constant time).
+  void Clear();
+
+ private:
+  // The score of winning at ply 0. Winning at ply p scores kWinScore - p, and losing at ply p
+  // scores -(kWinScore - p); a draw scores 0. Any score further than kMaxPly from 0 is a win or loss.
+  static constexpr int kWinScore = 1000;
+  static constexpr int kMaxPly = 100;
+
+  enum class Bound : uint8_t {
+    kExact,
+    kLower,
+    kUpper
+  };
+
+  // Scores in the table are stored relative to the entry's position rather than to the root,
+  // so that they are valid wherever the position is reached.
+  struct TableEntry {
+    uint64_t hash;
+    uint32_t generation;
+    int16_t score;
+    Bound bound;
+    uint8_t best_move;
+  };
+
+  size_t table_size_log2_;
+  size_t max_nodes_;
+  vector<TableEntry> table_;
+  uint32_t generation_;
+
+  size_t nodes_searched_;
+  bool out_of_nodes_;
+  uint8_t root_best_move_;
+
+  // Returns the score of the position for the player to move, with the given window, where the
+  // position is at the given ply from the root. Returns 0 if the node budget runs out.
+  int Search(const BitBoard& board, int alpha, int beta, size_t ply);
+
+  // Stores the result of searching a position, and returns its score.
+  int Store(const BitBoard& board, int score, Bound bound, uint8_t best_move, size_t ply);
+
+  // Moves are stored in one byte, as sub_board * kNumCells + cell.
+  static uint8_t EncodeMove(size_t sub_board, size_t cell);
+};
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+// A direct-mapped cache of the static values of positions, keyed by their hashes (see
+// BitBoard::GetHash), so that the search does not evaluate the same leaf again when it is
+// reached through a transposition, by a sibling subtree, or by the next iteration of iterative
+// deepening. Each hash has one slot, which a newer value for another hash overwrites. This
+// saves the most with evaluators that cost much more than a memory access, like
+// NeuralEvaluator; PatternEvaluator's lookups cost about as much as the cache's own.
+class EvaluationCache {
+ public:
+  static constexpr size_t kDefaultSizeLog2 = 16;
+  static constexpr size_t kMaxSizeLog2 = 32;
+
+  // The cache has 2^size_log2 entries (of 24 bytes each), and is allocated on the first call
+  // to Store. A size_log2 of 0 disables the cache: Probe always returns false, and Store does
+  // nothing. Throws an invalid_argument exception if size_log2 is greater than kMaxSizeLog2.
+  explicit EvaluationCache(size_t size_log2 = kDefaultSizeLog2);
+
+  bool IsEnabled() const;
+
+  // Returns true iff a value is stored for the hash, in which case value is set to it.
+  bool Probe(uint64_t hash, double& value) const;
+
+  void Store(uint64_t hash, double value);
+
+  // Discards all stored values (in constant time).
+  void Clear();
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    double value;
+    uint32_t generation;
+  };
+
+  size_t size_log2_;
+  vector<Entry> entries_;
+
+  // Entries stored before the last Clear have an older generation, and are ignored.
+  uint32_t generation_;
+};
+
+}  // namespace ultimate_tictactoe
+
+// Inline definitions for the methods used at every leaf of the search
+#include <core/evaluation_cache.hpp>
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <core/evaluation_cache.h>
+
+namespace ultimate_tictactoe {
+
+inline bool EvaluationCache::IsEnabled() const {
+  return size_log2_ > 0;
+}
+
+inline bool EvaluationCache::Probe(uint64_t hash, double& value) const {
+  if (entries_.empty()) {
+    return false;
+  }
+  const Entry& entry = entries_[hash & (entries_.size() - 1)];
+  if (entry.hash != hash || entry.generation != generation_) {
+    return false;
+  }
+  value = entry.value;
+  return true;
+}
+
+inline void EvaluationCache::Store(uint64_t hash, double value) {
+  if (entries_.empty()) {
+    if (!IsEnabled()) {
+      return;
+    }
+    entries_.resize(static_cast<size_t>(1) << size_log2_, Entry{0, 0, 0});
+  }
+  entries_[hash & (entries_.size() - 1)] = {hash, value, generation_};
+}
+
+}  // namespace ultimate_tictactoe
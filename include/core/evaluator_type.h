@@ -0,0 +1,14 @@
+#pragma once
+
+namespace ultimate_tictactoe {
+
+// The evaluators that MakeTreeSearchAI can make a tree search AI with, for choosing the
+// evaluator at runtime: kHeuristic is HeuristicEvaluator (the evaluator of TreeSearchAI),
+// kNeural is NeuralEvaluator, and kPattern is PatternEvaluator.
+enum class EvaluatorType {
+  kHeuristic,
+  kNeural,
+  kPattern
+};
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cmath>
+
+#include <core/heuristic_evaluator.h>
+
+namespace ultimate_tictactoe {
+
+inline double HeuristicEvaluator::Evaluate(const BitBoard& board) const {
+  Player active_player = board.GetCurrentPlayer();
+  Player opponent = (active_player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
+  return tanh((EvaluatePlayer(board, active_player) - EvaluatePlayer(board, opponent)) * kRescalingFactor);
+}
+
+inline double HeuristicEvaluator::EvaluatePlayer(const BitBoard& board, Player player) {
+  Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
+  const double* possible_win_line_counts =
+      possible_win_line_counts_ + board.GetWonSubBoards(opponent) * BitBoard::kNumCells;
+  double value = 0;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    size_t index = board.GetMarks(player, sub_board) * (BitBoard::kFullMask + 1) +
+                   board.GetMarks(opponent, sub_board);
+    value += kWinChanceMetrics[win_chance_metric_indices_[index]] * possible_win_line_counts[sub_board];
+  }
+  return value;
+}
+
+}  // namespace ultimate_tictactoe
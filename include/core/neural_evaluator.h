@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <core/bitboard.h>
+#include <core/player.h>
+#include <core/position_batch.h>
+
+namespace ultimate_tictactoe {
+
+using std::string;
+using std::vector;
+
+// The quantized weights of NeuralEvaluator's network (see there for how they are used).
+// Features are indexed by (sub_board * kNumCells + cell) * 2, plus 1 if the mark in the cell
+// is the opponent's (from the point of view of the accumulator's player) rather than their own.
+struct NeuralNetworkWeights {
+  static constexpr size_t kNumFeatures = BitBoard::kNumCells * BitBoard::kNumCells * 2;
+  static constexpr size_t kAccumulatorSize = 64;
+  static constexpr size_t kHiddenSize = 32;
+
+  int16_t feature_weights[kNumFeatures][kAccumulatorSize];
+  int16_t feature_biases[kAccumulatorSize];
+  int8_t hidden1_weights[kHiddenSize][2 * kAccumulatorSize];
+  int32_t hidden1_biases[kHiddenSize];
+  int8_t hidden2_weights[kHiddenSize][kHiddenSize];
+  int32_t hidden2_biases[kHiddenSize];
+  int8_t output_weights[kHiddenSize];
+  int32_t output_bias;
+};
+
+// Evaluates BitBoards with a small quantized neural network, in the style of the NNUE
+// evaluators of chess engines:
+//   - The first layer is an accumulator for each player: the feature biases plus the feature
+//     weights of every mark on the board, as seen by that player. The accumulators are updated
+//     incrementally as the search plays and reverses moves (see BasicTreeSearchAI), adding one
+//     column of weights to each, rather than recomputed at every leaf.
+//   - The accumulators (the player to move's first) are clipped to [0, kActivationMax] and go
+//     through two dense layers with int8 weights, whose outputs are shifted right by
+//     kWeightShift and clipped the same way, and then a dense output layer. The value is
+//     tanh(output / kOutputScale).
+// The dense layers use AVX2 or SSSE3 instructions when the compiler targets them (see the
+// USE_AVX2 option in CMakeLists.txt), and plain loops otherwise; all give the same values.
+//
+// The weights are all 0 (so every state has the value 0) until they are loaded from a file
+// or set. There is no trainer for them in this repository.
+class NeuralEvaluator {
+ public:
+  static constexpr char kMagic[9] = "UTTTNNUE";
+  static constexpr uint32_t kVersion = 1;
+  static constexpr int32_t kActivationMax = 127;
+  static constexpr int kWeightShift = 6;
+  static constexpr double kOutputScale = 8192;
+
+  // Batches save pushing and popping the accumulators of each leaf (see EvaluateBatch).
+  static constexpr bool kPrefersBatches = true;
+
+  // Each (sub-board, cell) has its own feature weights, so positions that are rotations or
+  // reflections of each other generally have different values.
+  static constexpr bool kIsSymmetric = false;
+
+  NeuralEvaluator();
+
+  // Loads the weights from the file with the given path. Throws a runtime_error exception if
+  // the file cannot be read or is not a valid weight file. File format: the 8 byte kMagic,
+  // a 4 byte version (kVersion), then the fields of NeuralNetworkWeights in order, all in the
+  // machine's native byte order (like OpeningBook).
+  void Load(const string& path);
+
+  // Writes the given weights to a file with the given path, in the format read by Load.
+  // Throws a runtime_error exception if the file cannot be written.
+  static void Write(const string& path, const NeuralNetworkWeights& weights);
+
+  void SetWeights(const NeuralNetworkWeights& weights);
+  const NeuralNetworkWeights& GetWeights() const;
+
+  // Returns the value of the position for the player to move, in (-1, 1). The board must be the
+  // state of the last Reset followed by the moves played (and not reversed) since; if Reset has
+  // not been called, the accumulators are computed from the board.
+  double Evaluate(const BitBoard& board) const;
+
+  // Sets values[i] to the value of the batch's i-th position, exactly as Evaluate would return
+  // it after PlayMove with the position's move. The positions must be those reached by their
+  // moves from the state of the last Reset followed by the moves played since, whose
+  // accumulators are copied and updated for each position without being kept; if Reset has not
+  // been called, the accumulators are computed from the positions' marks.
+  void EvaluateBatch(const PositionBatch& batch, double* values) const;
+
+  // Recomputes the accumulators from the board, discarding those of the moves played before.
+  void Reset(const BitBoard& board);
+
+  // Updates the accumulators for the given player's move, keeping the previous ones so that
+  // ReverseMove can restore them.
+  void PlayMove(Player player, size_t sub_board, size_t cell);
+  void ReverseMove();
+
+ private:
+  // The first layer's output for each player (indexed by Player).
+  struct Accumulator {
+    int16_t values[2][NeuralNetworkWeights::kAccumulatorSize];
+  };
+
+  std::unique_ptr<NeuralNetworkWeights> weights_;
+
+  // The accumulators of the state given to Reset, and after each move played since.
+  vector<Accumulator> accumulators_;
+
+  void ComputeAccumulator(const BitBoard& board, Accumulator& accumulator) const;
+
+  // Same as above, for the board whose marks in each sub-board are marks[player][sub_board].
+  void ComputeAccumulator(const uint16_t marks[2][BitBoard::kNumCells], Accumulator& accumulator) const;
+
+  // Runs the layers after the first on the accumulator, for the given player to move.
+  double EvaluateAccumulator(const Accumulator& accumulator, Player player) const;
+};
+
+}  // namespace ultimate_tictactoe
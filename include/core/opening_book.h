@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <core/action.h>
+#include <core/superboard.h>
+
+namespace ultimate_tictactoe {
+
+using std::string;
+using std::vector;
+
+// One position of an opening book, and the move found for it by a deep search. The position
+// is identified by its canonical hash (see BitBoard::GetCanonicalHash), and the move is given
+// for the canonical form of the position, as BitBoard's sub_board * kNumCells + cell.
+struct OpeningBookEntry {
+  uint64_t position_hash;
+  uint16_t move;
+
+  // The value of the move for the player to move, times kValueScale.
+  int16_t value;
+
+  // The depth that the move was searched to.
+  uint32_t depth;
+};
+
+// A read-only table of the best moves in early positions, stored in a file that is sorted by
+// position hash, so that positions are looked up with a binary search directly in the file.
+// Where possible, the file is memory-mapped rather than read, so opening it takes no time, and
+// processes that open the same book share its memory through the page cache.
+//
+// File format: the 8 byte kMagic, a 4 byte version (kVersion), and a 4 byte entry count,
+// followed by the entries (16 bytes each, in the order of OpeningBookEntry's fields) sorted
+// by position hash. All numbers are stored in the machine's native byte order, so books can
+// only be shared between machines with the same byte order.
+class OpeningBook {
+ public:
+  static constexpr char kMagic[9] = "UTTTBOOK";
+  static constexpr uint32_t kVersion = 1;
+  static constexpr double kValueScale = 10000;
+
+  // Initializes a book with no entries.
+  OpeningBook();
+
+  // Closes the book, if it is open.
+  ~OpeningBook();
+
+  // The book owns its mapping of the file, so it cannot be copied.
+  OpeningBook(const OpeningBook&) = delete;
+  OpeningBook& operator=(const OpeningBook&) = delete;
+
+  // Opens the book file with the given path, closing the book that was open, if any. Throws
+  // a runtime_error exception if the file cannot be read or is not a valid book.
+  void Open(const string& path);
+
+  // Closes the book, leaving it with no entries.
+  void Close();
+
+  bool IsOpen() const;
+  size_t GetNumEntries() const;
+
+  // Looks up the given position, and if the book has a move for it that was searched to at
+  // least min_depth, sets move to that move (transformed back from the canonical form of the
+  // position) and returns true. Otherwise, returns false without modifying move.
+  bool Probe(const SuperBoard& board, size_t min_depth, Action& move) const;
+
+  // Writes the given entries to a book file with the given path, sorting them by position
+  // hash. If several entries have the same hash, only the one searched deepest is kept.
+  // Throws a runtime_error exception if the file cannot be written.
+  static void Write(const string& path, vector<OpeningBookEntry> entries);
+
+ private:
+  // Whether a book was opened, which is tracked separately since an empty book may have no
+  // entries to point to.
+  bool is_open_;
+  const OpeningBookEntry* entries_;
+  size_t num_entries_;
+
+  // The mapped file (including the header). On platforms without mmap, the entries are read
+  // into read_entries_ instead.
+  void* mapped_data_;
+  size_t mapped_size_;
+  vector<OpeningBookEntry> read_entries_;
+};
+
+}  // namespace ultimate_tictactoe
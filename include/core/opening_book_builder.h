@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include <core/opening_book.h>
+#include <core/superboard.h>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+// Builds the entries of an opening book (see OpeningBook) by searching every position that can
+// be reached in the first num_plies plies of a game to the given depth. Positions that are
+// equivalent by symmetry are only searched once, which shrinks the early tree a lot (e.g. the
+// 81 first moves fall into 15 classes). The searches are spread over num_threads threads, each
+// with its own TreeSearchAI.
+class OpeningBookBuilder {
+ public:
+  // Throws an invalid_argument exception if search_depth or num_threads is 0.
+  OpeningBookBuilder(size_t num_plies, size_t search_depth, size_t num_threads);
+
+  // Returns one position of each class of equivalent positions that can be reached in fewer
+  // than num_plies plies (starting with the empty board), excluding complete positions.
+  vector<SuperBoard> GetPositions() const;
+
+  // Searches each position returned by GetPositions, and returns the resulting entries. If log
+  // is not nullptr, progress is written to it as positions are finished.
+  vector<OpeningBookEntry> Build(std::ostream* log = nullptr) const;
+
+ private:
+  // How often (in positions searched) progress is written to the log.
+  static constexpr size_t kPositionsPerLogUpdate = 100;
+
+  size_t num_plies_;
+  size_t search_depth_;
+  size_t num_threads_;
+
+  // Searches the given position, and returns its entry.
+  OpeningBookEntry SearchPosition(const SuperBoard& board) const;
+};
+
+}  // namespace ultimate_tictactoe
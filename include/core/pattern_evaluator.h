@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <core/bitboard.h>
+#include <core/player.h>
+#include <core/position_batch.h>
+
+namespace ultimate_tictactoe {
+
+using std::string;
+using std::vector;
+
+// Evaluates BitBoards with learned weight tables, in the style of the pattern evaluators of
+// Othello engines. Each sub-board's marks are a pattern of 3^9 configurations, and the weight
+// of the pattern is looked up in a table chosen by:
+//   - the sub-board's position class (corner, edge, or center of the board). The patterns of
+//     corner and edge sub-boards are rotated or reflected so that the sub-board is the top left
+//     corner or top edge, which lets the sub-boards of a class share their table.
+//   - the sub-board's macro context: whether it is on a line of sub-boards that the player to
+//     move can still win along, and whether it is on one that the opponent can.
+// The value is tanh of the sum of the nine weights and a bias, so evaluating a position takes
+// 9 table lookups. The tables are fitted to the results of recorded games by PatternTrainer,
+// which makes them the learned counterpart of the guessed win chance metrics of
+// TreeSearchAI::ConvertMoveCountToWinChanceMetric.
+//
+// The weights are all 0 (so every state has the value 0) until they are loaded from a file
+// or set.
+class PatternEvaluator {
+ public:
+  static constexpr char kMagic[9] = "UTTTPATT";
+  static constexpr uint32_t kVersion = 1;
+
+  static constexpr size_t kNumPositionClasses = 3;
+  static constexpr size_t kNumContexts = 4;
+  static constexpr size_t kNumPatterns = 19683;
+
+  // The weights are indexed by
+  // (position_class * kNumContexts + context) * kNumPatterns + pattern, where the position
+  // class is 0 for corners, 1 for edges and 2 for the center, bit 0 of the context is set iff
+  // the player to move can still win along a line through the sub-board and bit 1 iff the
+  // opponent can, and the pattern is the sum over the (transformed) cells of 3^cell times 0
+  // for an empty cell, 1 for the player to move's mark, and 2 for the opponent's. The bias is
+  // the last weight.
+  static constexpr size_t kBiasWeight = kNumPositionClasses * kNumContexts * kNumPatterns;
+  static constexpr size_t kNumWeights = kBiasWeight + 1;
+
+  // The number of weights that are added up for each position: one per sub-board, then the bias.
+  static constexpr size_t kNumActiveWeights = BitBoard::kNumCells + 1;
+
+  // Looking up each sub-board's weights for a whole batch at a time is faster than evaluating
+  // the positions one by one (see EvaluateBatch).
+  static constexpr bool kPrefersBatches = true;
+
+  // Each sub-board's pattern is transformed by only one of the symmetries that move it to the
+  // first sub-board of its class, so positions that are rotations or reflections of each other
+  // can have different values.
+  static constexpr bool kIsSymmetric = false;
+
+  PatternEvaluator();
+
+  // Loads the weights from the file with the given path. Throws a runtime_error exception if
+  // the file cannot be read or is not a valid weight file. File format: the 8 byte kMagic,
+  // a 4 byte version (kVersion), then the kNumWeights weights as 4 byte floats, all in the
+  // machine's native byte order (like OpeningBook).
+  void Load(const string& path);
+
+  // Writes the given weights to a file with the given path, in the format read by Load.
+  // Throws an invalid_argument exception if there are not kNumWeights weights, and a
+  // runtime_error exception if the file cannot be written.
+  static void Write(const string& path, const vector<float>& weights);
+
+  // Throws an invalid_argument exception if there are not kNumWeights weights.
+  void SetWeights(const vector<float>& weights);
+  const vector<float>& GetWeights() const;
+
+  // Sets indices to the indices of the weights that are added up to evaluate the board.
+  static void GetActiveWeights(const BitBoard& board, size_t indices[kNumActiveWeights]);
+
+  // Returns the value of the position for the player to move, in (-1, 1).
+  double Evaluate(const BitBoard& board) const;
+
+  // Sets values[i] to the value of the batch's i-th position, exactly as Evaluate would return
+  // it. Each sub-board's weights are looked up for every position before the next sub-board's.
+  void EvaluateBatch(const PositionBatch& batch, double* values) const;
+
+  // The value is computed from the board alone, so the moves played by the search (see
+  // BasicTreeSearchAI) are ignored.
+  void Reset(const BitBoard&) {}
+  void PlayMove(Player, size_t, size_t) {}
+  void ReverseMove() {}
+
+ private:
+  vector<float> weights_;
+};
+
+}  // namespace ultimate_tictactoe
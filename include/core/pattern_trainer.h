@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <core/action.h>
+#include <core/bitboard.h>
+#include <core/pattern_evaluator.h>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+// Fits the weights of a PatternEvaluator to recorded games, offline. Every position of a game
+// (before each move) is recorded with the game's result for the player to move in it: kWonGameValue
+// for a win, -kWonGameValue for a loss, and 0 for a tie. Since the evaluator's value is tanh of the
+// sum of the active weights, the targets of the sums are the atanh of the results, and Fit finds
+// the weights whose sums are closest to them by least squares.
+//
+// The games can come from anywhere, e.g. PlayGames, which records games of TreeSearchAI
+// against itself.
+class PatternTrainer {
+ public:
+  // The value that the positions of won games are fitted to. It is less than 1, whose atanh is
+  // infinite, but close to it, so that won positions evaluate near the top of the evaluator's
+  // range (-1, 1) rather than at tanh(1).
+  static constexpr double kWonGameValue = 0.9;
+
+  // Throws an invalid_argument exception if search_depth or num_threads is 0.
+  PatternTrainer(size_t search_depth, size_t num_random_plies, size_t num_threads);
+
+  // Plays num_games games of TreeSearchAI against itself, searching to the search depth, and
+  // returns their moves. The first num_random_plies moves of each game are chosen uniformly at
+  // random instead, so that the games differ. The games are spread over num_threads threads,
+  // and the random moves of each game depend only on the seed and the game's index, so the
+  // games are the same for any number of threads. If log is not nullptr, progress is written
+  // to it as games are finished.
+  vector<vector<Action>> PlayGames(size_t num_games, uint64_t seed, std::ostream* log = nullptr) const;
+
+  // Records the positions of a game that starts with the empty board, and in which the moves
+  // are played until the game is complete. Throws an invalid_argument exception if a move is
+  // not valid, or if the game is not complete after the moves; no positions are recorded then.
+  void AddGame(const vector<Action>& moves);
+
+  // Records a position, with the target of its value before tanh (i.e. the atanh of the target
+  // of its value).
+  void AddPosition(const BitBoard& board, double target);
+
+  size_t GetNumPositions() const;
+
+  // Returns the weights that minimize the sum of the squared differences between the sums of
+  // the positions' active weights (see PatternEvaluator::GetActiveWeights) and their targets,
+  // plus regularization times the sum of the squared weights (which keeps the weights of rare
+  // patterns small, and those of patterns that were never seen 0). Since every position has
+  // the same number of active weights, the problem is sparse, and it is solved by
+  // num_iterations iterations of the conjugate gradient method on the normal equations
+  // (CGLS), each of which only goes over the active weights of each position twice.
+  vector<float> Fit(double regularization, size_t num_iterations) const;
+
+  // Returns the mean of the squared differences between the sums of the positions' active
+  // weights and their targets, with the given weights (0 if there are no positions). Throws an
+  // invalid_argument exception if there are not PatternEvaluator::kNumWeights weights.
+  double GetMeanSquaredError(const vector<float>& weights) const;
+
+ private:
+  // How often (in games played) progress is written to the log.
+  static constexpr size_t kGamesPerLogUpdate = 100;
+
+  size_t search_depth_;
+  size_t num_random_plies_;
+  size_t num_threads_;
+
+  // The active weights of each position, kNumActiveWeights per position, and the targets.
+  vector<uint32_t> active_weights_;
+  vector<double> targets_;
+
+  // Plays one game as described in PlayGames, with the given seed for its random moves.
+  vector<Action> PlayGame(uint64_t seed) const;
+};
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <core/bitboard.h>
+#include <core/player.h>
+
+namespace ultimate_tictactoe {
+
+// A batch of positions for evaluating together (see the evaluators' EvaluateBatch methods), laid
+// out as a structure of arrays: each field has one entry per position, so that the same field
+// of consecutive positions is contiguous for loops over the batch. The positions are typically
+// the children of one state in the search, which is also why the move that led to each position
+// is kept (for evaluators that update their state incrementally).
+//
+// Marks are stored from the point of view of the player to move in each position: index 0 is
+// the player to move's, and index 1 the opponent's.
+struct PositionBatch {
+  // Enough for every child of a state.
+  static constexpr size_t kMaxSize = BitBoard::kNumCells * BitBoard::kNumCells;
+
+  size_t size;
+  Player players_to_move[kMaxSize];
+  uint16_t marks[2][BitBoard::kNumCells][kMaxSize];
+  uint16_t won_sub_boards[2][kMaxSize];
+  uint16_t complete_sub_boards[kMaxSize];
+  uint8_t move_sub_boards[kMaxSize];
+  uint8_t move_cells[kMaxSize];
+
+  PositionBatch();
+
+  // Removes all positions from the batch.
+  void Clear();
+
+  // Adds the board to the end of the batch, reached by playing the given move. The batch must
+  // have fewer than kMaxSize positions.
+  void Add(const BitBoard& board, size_t move_sub_board, size_t move_cell);
+};
+
+}  // namespace ultimate_tictactoe
+
+// Inline definitions for the methods used at the leaves of the search
+#include <core/position_batch.hpp>
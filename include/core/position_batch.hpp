@@ -0,0 +1,29 @@
+#pragma once
+
+#include <core/position_batch.h>
+
+namespace ultimate_tictactoe {
+
+inline PositionBatch::PositionBatch() : size(0) {}
+
+inline void PositionBatch::Clear() {
+  size = 0;
+}
+
+inline void PositionBatch::Add(const BitBoard& board, size_t move_sub_board, size_t move_cell) {
+  Player player = board.GetCurrentPlayer();
+  Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
+  players_to_move[size] = player;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    marks[0][sub_board][size] = board.GetMarks(player, sub_board);
+    marks[1][sub_board][size] = board.GetMarks(opponent, sub_board);
+  }
+  won_sub_boards[0][size] = board.GetWonSubBoards(player);
+  won_sub_boards[1][size] = board.GetWonSubBoards(opponent);
+  complete_sub_boards[size] = board.GetCompleteSubBoards();
+  move_sub_boards[size] = static_cast<uint8_t>(move_sub_board);
+  move_cells[size] = static_cast<uint8_t>(move_cell);
+  size++;
+}
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <core/action.h>
+#include <core/bitboard.h>
+#include <core/player.h>
+#include <core/superboard.h>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+enum class ProofResult {
+  // The search ran out of nodes before finding out.
+  kUnknown,
+
+  // The player to move can force a win.
+  kProven,
+
+  // The player to move cannot force a win (the opponent can force a win or a draw).
+  kDisproven
+};
+
+// Answers whether the player to move (the attacker) can force a win, with depth-first
+// proof-number search (df-pn). Rather than searching every move to a fixed depth like
+// alpha-beta, proof-number search expands the moves that are closest to proving or
+// disproving the win, so it can find long but narrow forcing sequences (e.g. repeatedly
+// sending the opponent to a sub-board where they cannot stop a threat) at a small fraction
+// of the cost of a full-width search.
+//
+// The proof and disproof numbers of searched positions are kept in a fixed-size hash table,
+// which is kept between calls (so a search can build on the previous one, e.g. after the
+// moves of the proof are played), and each call has a node budget. Since moves cannot be
+// undone, positions never repeat, so the game tree has no cycles.
+class ProofNumberSearch {
+ public:
+  static constexpr size_t kDefaultTableSizeLog2 = 18;
+
+  // The table has 2^table_size_log2 entries (of 24 bytes each), and is allocated on the first
+  // call to ProveWin.
+  explicit ProofNumberSearch(size_t table_size_log2 = kDefaultTableSizeLog2);
+
+  // Searches whether the player to move in the given state can force a win, expanding at most
+  // max_nodes nodes. If the win is proven, winning_move is set to the first move of the proof
+  // (otherwise it is not modified). Throws a runtime_error exception if the game is complete.
+  ProofResult ProveWin(const SuperBoard& board, size_t max_nodes, Action& winning_move);
+
+  // Returns the number of nodes expanded by the last call to ProveWin.
+  size_t GetNodesSearched() const;
+
+  // Discards all positions remembered in the table (in constant time).
+  void Clear();
+
+ private:
+  // Proof and disproof numbers are saturated at kInfinity, which means the position is
+  // disproven (for the proof number) or proven (for the disproof number).
+  static constexpr uint32_t kInfinity = UINT32_MAX;
+
+  struct ProofNumbers {
+    uint32_t proof;
+    uint32_t disproof;
+  };
+
+  struct TableEntry {
+    uint64_t key;
+    uint32_t generation;
+    ProofNumbers numbers;
+  };
+
+  size_t table_size_log2_;
+  vector<TableEntry> table_;
+  uint32_t generation_;
+
+  Player attacker_;
+  size_t max_nodes_;
+  size_t nodes_searched_;
+  uint8_t root_winning_move_;
+
+  // Searches the position until its proof number reaches proof_threshold or its disproof
+  // number reaches disproof_threshold (or it is proven or disproven, or the node budget runs
+  // out), and returns its proof and disproof numbers.
+  ProofNumbers Search(const BitBoard& board, uint32_t proof_threshold, uint32_t disproof_threshold, size_t ply);
+
+  // Returns the proof and disproof numbers of a position that has not been expanded by this
+  // search: exact ones if the game is complete or a dead draw, otherwise those in the table (or
+  // 1 and 1).
+  ProofNumbers GetInitialProofNumbers(const BitBoard& board) const;
+
+  // Table keys depend on the attacker too, since the numbers mean different things for each.
+  uint64_t GetKey(const BitBoard& board) const;
+
+  // Saturating addition, keeping kInfinity for infinite sums.
+  static uint32_t AddProofNumbers(uint32_t n1, uint32_t n2);
+};
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <core/bitboard.h>
+#include <core/superboard.h>
+#include <core/win_state.h>
+
+namespace ultimate_tictactoe {
+
+// Small, fast pseudorandom number generator (Marsaglia's xorshift64*). Not
+// suitable for anything cryptographic, but its statistical quality is more than
+// enough for choosing playout moves, and it costs a handful of instructions per number.
+class XorShiftRandom {
+ public:
+  // The seed may be any value; a seed of 0 is remapped, since xorshift cannot
+  // leave the all-zero state.
+  explicit XorShiftRandom(uint64_t seed);
+
+  uint64_t Next();
+
+  // Returns a number in the range [0, bound). Uses a multiply-and-shift instead of
+  // a modulo, which is faster and has negligible bias for the small bounds used here.
+  size_t NextBelow(size_t bound);
+
+ private:
+  uint64_t state_;
+};
+
+// Plays positions to completion with uniformly random legal moves. This is the
+// kernel for playout-based evaluation (e.g. Monte Carlo tree search, or estimating
+// win rates), so it works on a BitBoard copy of the position: there is no move
+// validation, no move history, and no allocation, and only the outcome is returned.
+class RandomPlayout {
+ public:
+  static constexpr uint64_t kDefaultSeed = 0x9E3779B97F4A7C15ULL;
+
+  explicit RandomPlayout(uint64_t seed = kDefaultSeed);
+
+  // Plays random moves from the given position until the game is complete, and
+  // returns the final WinState. The passed-in board is not modified.
+  WinState Play(BitBoard board);
+  WinState Play(const SuperBoard& board);
+
+  // Returns the total number of moves played by this object over all playouts,
+  // which is useful for measuring throughput.
+  size_t GetMovesPlayed() const;
+
+ private:
+  XorShiftRandom random_;
+  size_t moves_played_;
+};
+
+}  // namespace ultimate_tictactoe
+
+// Inline definitions for the methods used in hot loops
+#include <core/random_playout.hpp>
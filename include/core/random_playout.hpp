@@ -0,0 +1,19 @@
+#pragma once
+
+#include <core/random_playout.h>
+
+namespace ultimate_tictactoe {
+
+inline uint64_t XorShiftRandom::Next() {
+  state_ ^= state_ >> 12;
+  state_ ^= state_ << 25;
+  state_ ^= state_ >> 27;
+  return state_ * 0x2545F4914F6CDD1DULL;
+}
+
+inline size_t XorShiftRandom::NextBelow(size_t bound) {
+  // Uses the upper 32 bits, which are the highest quality bits of xorshift64*.
+  return static_cast<size_t>(((Next() >> 32) * static_cast<uint64_t>(bound)) >> 32);
+}
+
+}  // namespace ultimate_tictactoe
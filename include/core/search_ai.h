@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+
+#include <core/ai.h>
+#include <core/opening_book.h>
+#include <core/selective_search_settings.h>
+
+namespace ultimate_tictactoe {
+
+// The methods of the tree search AIs (see BasicTreeSearchAI) that do not depend on their
+// evaluator, so that code choosing the evaluator at runtime (see MakeTreeSearchAI) can use
+// them through a pointer. Only calls made through this interface are virtual; the search
+// itself calls the evaluator directly. See TreeSearchAI for what each method does.
+class SearchAI : public AI {
+ public:
+  virtual void SetEndgameSolverThreshold(size_t num_open_cells) = 0;
+  virtual void SetProofSearchNodes(size_t max_nodes) = 0;
+  virtual void SetOpeningBook(const OpeningBook* opening_book) = 0;
+  virtual void SetSelectiveSearch(const SelectiveSearchSettings& settings) = 0;
+  virtual void SetEvaluationCacheSize(size_t size_log2) = 0;
+  virtual void SetSearchDepth(size_t search_depth) = 0;
+
+  virtual void StartPondering() = 0;
+  virtual void StopPondering() = 0;
+
+  virtual void BeginSteppedSearch() = 0;
+  virtual bool StepSearch(std::chrono::milliseconds time_slice) = 0;
+  virtual bool IsSteppedSearchRunning() const = 0;
+  virtual Action FinishSteppedSearch() = 0;
+};
+
+}  // namespace ultimate_tictactoe
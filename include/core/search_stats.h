@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace ultimate_tictactoe {
+
+using std::vector;
+
+// Counts of the work done by a single search, used for tuning the search and for
+// estimating how much work deeper searches will take. A node is a state visited by
+// the search; ply 0 is the state the search started from.
+struct SearchStats {
+  size_t nodes;
+
+  // Nodes evaluated with the heuristic (EvaluateState), because the search depth ran out.
+  size_t leaf_evaluations;
+
+  // Nodes where the game was complete.
+  size_t terminal_hits;
+
+  // Nodes whose value was proven by the endgame solver, rather than searched, and nodes where
+  // the solver ran out of nodes (the solver is not tried again below those).
+  size_t endgame_solves;
+  size_t endgame_solver_failures;
+
+  // Nodes expanded by the proof search run before the search (see
+  // TreeSearchAI::SetProofSearchNodes), which are not counted in nodes. Its time is counted in
+  // elapsed_seconds.
+  size_t proof_search_nodes;
+
+  // Nodes where the player to move could win the game with one action, which was returned
+  // without searching, and actions left out because the opponent could win the game right
+  // after them.
+  size_t immediate_wins;
+  size_t unsafe_actions_skipped;
+
+  // Actions left out because the state is symmetric, and another action leads to an
+  // equivalent state (see BitBoard::GetStabilizerSymmetries).
+  size_t symmetric_actions_skipped;
+
+  // Selective search (see SelectiveSearchSettings): actions searched with a late move
+  // reduction and how many of those were searched again at full depth, actions and states
+  // pruned by futility pruning, and states whose search was cut short by razoring.
+  size_t late_move_reductions;
+  size_t late_move_researches;
+  size_t futility_prunes;
+  size_t razorings;
+
+  // Nodes whose search was pruned because an action reached beta, and how many of those
+  // were pruned by the first action searched. A high first move rate means that the
+  // moves are well ordered.
+  size_t beta_cutoffs;
+  size_t first_move_cutoffs;
+
+  // The number of nodes visited at each ply.
+  vector<size_t> nodes_per_ply;
+
+  // Evaluation cache lookups (see EvaluationCache) and how many found the state's value. These
+  // stay 0 for searches that do not use the cache.
+  size_t eval_cache_probes;
+  size_t eval_cache_hits;
+
+  double elapsed_seconds;
+
+  // Sets all counts to 0.
+  void Reset();
+
+  // Counts a node visited at the given ply.
+  void RecordNode(size_t ply);
+
+  // Counts a beta cutoff, caused by the action at the given index in the order searched.
+  void RecordCutoff(size_t action_index);
+
+  // Returns the fraction of beta cutoffs caused by the first action searched, or 0 if
+  // there were no cutoffs.
+  double GetFirstMoveCutoffRate() const;
+
+  // Returns the fraction of evaluation cache lookups that found the state's value, or 0 if
+  // there were no lookups.
+  double GetEvaluationCacheHitRate() const;
+
+  // Returns the effective branching factor at the given ply, which is the number of nodes
+  // at the next ply divided by the number at this ply, or 0 if there are no nodes at
+  // either of them.
+  double GetEffectiveBranchingFactor(size_t ply) const;
+
+  // Returns the number of nodes searched per second, or 0 if no time has been recorded.
+  double GetNodesPerSecond() const;
+};
+
+// Writes a one-line summary of the stats, followed by the effective branching factor
+// at each ply.
+std::ostream& operator<<(std::ostream& os, const SearchStats& stats);
+
+}  // namespace ultimate_tictactoe
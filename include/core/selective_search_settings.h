@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ultimate_tictactoe {
+
+// Settings for TreeSearchAI's selective search (see TreeSearchAI::SetSelectiveSearch), which
+// searches the actions that are unlikely to matter less deeply than the rest, or not at all.
+// Depths are the number of levels left to search at a state, and margins are in the units of
+// state values (heuristic values are in (-1, 1)). A depth setting of 0 disables its technique.
+//
+// An action is quiet if it does not complete a sub-board (or the game). Quiet actions are the
+// only ones that are reduced or pruned, since completing a sub-board changes the heuristic
+// value the most.
+struct SelectiveSearchSettings {
+  // Late move reductions: at states with at least lmr_min_depth levels left, quiet actions
+  // after the first lmr_first_reduced_action actions are searched lmr_reduction levels less
+  // deeply (but at least 1 level deep). If a reduced action turns out better than alpha, it is
+  // searched again at full depth.
+  size_t lmr_min_depth;
+  size_t lmr_first_reduced_action;
+  size_t lmr_reduction;
+
+  // Futility pruning: at states with at most futility_max_depth levels left, if the heuristic
+  // value of the state plus futility_margin per level left is at most alpha, the quiet actions
+  // after the first one are skipped, since they are unlikely to raise alpha. Conversely, if the
+  // heuristic value minus futility_margin per level left is at least beta, the state is pruned
+  // without searching its actions, with that value.
+  size_t futility_max_depth;
+  double futility_margin;
+
+  // Razoring: at states with at most razoring_max_depth levels left, if the heuristic value of
+  // the state plus razoring_margin is at most alpha, the state is searched only 1 level deep.
+  size_t razoring_max_depth;
+  double razoring_margin;
+
+  // Returns settings with every technique disabled, which is a full-width search.
+  static SelectiveSearchSettings Disabled();
+
+  // Returns settings that, in self-play at search depths 4 and 5, play about as well as the
+  // full-width search to the same depth with about half the nodes. Reductions are by 2 levels,
+  // since reducing by 1 changes which player's move the search ends on, which the heuristic
+  // is sensitive to. Razoring is disabled, since it made play worse in the same matches.
+  static SelectiveSearchSettings Suggested();
+};
+
+}  // namespace ultimate_tictactoe
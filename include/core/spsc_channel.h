@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace ultimate_tictactoe {
+
+// A fixed-capacity, lock-free queue for passing values from exactly one producer
+// thread to exactly one consumer thread. Neither side ever blocks: pushing to a full
+// channel and popping from an empty one fail immediately, so that a busy consumer
+// (e.g. the render loop) can never stall the producer (e.g. a search), or vice versa.
+//
+// The channel is a ring buffer. The producer only writes tail_ and the consumer only
+// writes head_; each publishes its writes to the other with release/acquire ordering.
+template <typename T, size_t kCapacity>
+class SpscChannel {
+ public:
+  SpscChannel();
+
+  // Producer only. Copies the value into the channel, or returns false if the channel is full.
+  bool TryPush(const T& value);
+
+  // Consumer only. Moves the oldest value in the channel into value, or returns false (leaving
+  // value unchanged) if the channel is empty.
+  bool TryPop(T& value);
+
+  // Consumer only. Pops every value in the channel, keeping only the newest in value. Returns
+  // false if the channel was empty.
+  bool TryPopLatest(T& value);
+
+ private:
+  // One slot is always left empty, to tell a full channel apart from an empty one.
+  static constexpr size_t kNumSlots = kCapacity + 1;
+
+  T slots_[kNumSlots];
+
+  // Index of the oldest value (written by the consumer) and of the slot for the next
+  // value (written by the producer).
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+};
+
+}  // namespace ultimate_tictactoe
+
+// Needed for template instantiation
+#include <core/spsc_channel.hpp>
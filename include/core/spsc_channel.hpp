@@ -0,0 +1,47 @@
+#pragma once
+
+#include <utility>
+
+#include <core/spsc_channel.h>
+
+namespace ultimate_tictactoe {
+
+template <typename T, size_t kCapacity>
+constexpr size_t SpscChannel<T, kCapacity>::kNumSlots;
+
+template <typename T, size_t kCapacity>
+SpscChannel<T, kCapacity>::SpscChannel() : head_(0), tail_(0) {}
+
+template <typename T, size_t kCapacity>
+bool SpscChannel<T, kCapacity>::TryPush(const T& value) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  size_t next_tail = (tail + 1) % kNumSlots;
+  if (next_tail == head_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  slots_[tail] = value;
+  tail_.store(next_tail, std::memory_order_release);
+  return true;
+}
+
+template <typename T, size_t kCapacity>
+bool SpscChannel<T, kCapacity>::TryPop(T& value) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  value = std::move(slots_[head]);
+  head_.store((head + 1) % kNumSlots, std::memory_order_release);
+  return true;
+}
+
+template <typename T, size_t kCapacity>
+bool SpscChannel<T, kCapacity>::TryPopLatest(T& value) {
+  bool popped = false;
+  while (TryPop(value)) {
+    popped = true;
+  }
+  return popped;
+}
+
+}  // namespace ultimate_tictactoe
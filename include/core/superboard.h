@@ -59,6 +59,13 @@ class SuperBoard : public Board<SubBoard> {
   
   // Returns true iff there is a required next sub-board specified.
   bool NextRequiredSubBoardExists() const;
+
+  // Returns true iff neither player can win the game anymore, because every row, column, and
+  // diagonal of sub-boards has a tied sub-board or sub-boards won by both players. The game
+  // then ends in a tie however it is played out, even if it is not complete yet. Also returns
+  // true for games that are complete and tied. Maintained incrementally, so this takes
+  // constant time.
+  bool IsDeadDraw() const;
   
  private:
   Player current_player_;
@@ -75,6 +82,11 @@ class SuperBoard : public Board<SubBoard> {
   // Used for reversing actions easily. May also be useful for displaying a move
   // history to the user (stretch goal).
   vector<MoveHistoryEntry> move_history_;
+
+  // The number of rows, columns, and diagonals of sub-boards that at least one player can
+  // still win (see IsDeadDraw). Only changes when a sub-board is completed, or when
+  // ReverseAction makes a complete sub-board incomplete again.
+  size_t num_winnable_lines_;
   
   bool SubBoardOutOfBounds(const Action& a) const;
   
@@ -85,6 +97,14 @@ class SuperBoard : public Board<SubBoard> {
   bool InRequiredSubBoard(const Action& a) const;
   
   void SwapCurrentPlayer();
+
+  // Returns the number of winnable lines through the sub-board at the given row and column,
+  // taking that sub-board's state to be sub_board_state rather than its actual state.
+  size_t CountWinnableLinesThrough(size_t row, size_t col, WinState sub_board_state) const;
+
+  // Returns true iff a line of sub-boards with the given kBoardSize states is winnable, i.e. it has
+  // no tied sub-boards, and not sub-boards won by both players.
+  static bool IsLineWinnable(const WinState line_states[]);
 };
   
 }  // namespace ultimate_tictactoe
\ No newline at end of file
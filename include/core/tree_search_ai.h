@@ -1,8 +1,29 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 
 #include <core/ai.h>
+#include <core/analysis_line.h>
+#include <core/endgame_solver.h>
+#include <core/evaluation_cache.h>
+#include <core/evaluator_type.h>
+#include <core/heuristic_evaluator.h>
+#include <core/neural_evaluator.h>
+#include <core/opening_book.h>
+#include <core/pattern_evaluator.h>
+#include <core/position_batch.h>
+#include <core/proof_number_search.h>
+#include <core/search_ai.h>
+#include <core/search_stats.h>
+#include <core/selective_search_settings.h>
 
 namespace ultimate_tictactoe {
   
@@ -10,15 +31,168 @@ using std::pair;
 
 // Only works for kBoardSize = 3 boards. To generalize, generalize the implementation of
 // ConvertMoveCountToWinChanceMetric.
-class TreeSearchAI : public AI {
+//
+// The search evaluates states with an Evaluator, which must be default constructible and have
+// these methods:
+//   - double Evaluate(const BitBoard& board), returning the value of the state for the player to
+//     move, in (-1, 1) (like EvaluateState).
+//   - static constexpr bool kPrefersBatches, true iff the search should evaluate the leaves of
+//     its last level with EvaluateBatch (see SearchFrontierActions) rather than one at a time.
+//   - void EvaluateBatch(const PositionBatch& batch, double* values), only if kPrefersBatches is
+//     true, setting values[i] to the value Evaluate would return for the batch's i-th position.
+//     The batches are children of the state reached by the actions played (see below), reached
+//     by the positions' moves.
+//   - static constexpr bool kIsSymmetric, true iff Evaluate gives the same value to positions that
+//     the board's rotations and reflections transform into each other. Only then does the search
+//     skip actions that are equivalent by symmetry (see EvaluateStateWithSearch).
+//   - void Reset(const BitBoard& board), called with the state each search starts from.
+//   - void PlayMove(Player player, size_t sub_board, size_t cell) and void ReverseMove(), called
+//     when the search plays an action (given like BitBoard::PlayMove's arguments, with the player
+//     who plays it) and when it reverses the last one played, so that evaluators can update
+//     their state incrementally. Evaluate is then called with the state after those actions.
+// The evaluator is a template parameter, rather than a virtual class, so that its methods can be
+// inlined into the search, which calls them at every node. TreeSearchAI uses HeuristicEvaluator;
+// MakeTreeSearchAI chooses the evaluator at runtime. Each evaluator that is used must be
+// instantiated in tree_search_ai.cc.
+template <typename Evaluator>
+class BasicTreeSearchAI : public SearchAI {
  public:
   // Used in the RescaleEvaluation function.
   const double kRescalingFactor = 0.6;
+
+  // The value of winning the game at the state the search started from. Winning after d plies
+  // (counted from there) has the value kWinValue - d * kWinDistanceStep, so faster wins have
+  // higher values, and every win is above the heuristic values in (-1, 1), even after the
+  // longest possible game. Losing has the negated value of winning. Since values depend on the
+  // ply they were found at, a table storing them across positions would have to store them
+  // relative to the position (adding ply * kWinDistanceStep to wins, and subtracting it from
+  // losses) and convert them back when probing, like EndgameSolver does.
+  static constexpr double kWinValue = 2;
+  static constexpr double kWinDistanceStep = 0.01;
+
+  // A good threshold for SetEndgameSolverThreshold: endgames with at most this many open
+  // cells are typically solved in well under a millisecond.
+  static constexpr size_t kSuggestedEndgameSolverThreshold = 12;
+
+  // A good node budget for SetProofSearchNodes: proof searches this large typically take
+  // 10-30 milliseconds.
+  static constexpr size_t kSuggestedProofSearchNodes = 100000;
+
+  BasicTreeSearchAI();
+
+  // Stops pondering and cancels the search, if the AI is doing either.
+  ~BasicTreeSearchAI() override;
   
   // Retrieves the best move as determined by the AI, given the current state of the AI.
   // Uses tree search with alpha-beta pruning. Throws a runtime_error exception if there are 
   // no valid moves, i.e. the game is complete.
+  //
+  // If the opening book (see SetOpeningBook) has a move for the state that was searched at
+  // least as deep as the search depth, the book move is returned without searching. Otherwise,
+  // if the proof search is enabled (see SetProofSearchNodes) and proves that the player to move
+  // can force a win, the first move of the proof is returned without searching. Then, if
+  // pondering found the best reply to the opponent's last move, that reply is returned without
+  // searching again (it is the same move that the search would return). The background and
+  // stepped searches use the book, the proof search, and pondered replies in the same way.
   Action GetMove();
+
+  // Stops pondering, then starts searching on a background thread (see AI::StartSearch).
+  // The background search uses iterative deepening: the position is searched at depth 1,
+  // 2, ..., up to the depth set by SetSearchDepth, and the best move and principal variation
+  // so far are updated after each depth is completed. Each depth searches the principal
+  // variation of the previous depth first, which makes pruning more effective. If stopped
+  // early, the search returns the best move of the deepest completed search (or the first
+  // valid move, if no depth was completed).
+  //
+  // Because of this move ordering, when several moves are equally good, the background
+  // search may choose a different one of them than GetMove.
+  std::shared_future<Action> StartSearch() override;
+
+  // Returns the deepest search depth completed by the current (or last) background search.
+  size_t GetCompletedSearchDepth() const;
+
+  // Returns the principal variation of the last search for a move: the line of moves,
+  // starting with the move found, that the search expects both players to play. For a
+  // background search, this is the line from the deepest depth completed so far, and it
+  // may be called while the search is running. After a ponder hit, only the move itself
+  // is known. Empty if there has been no search since the state last changed.
+  vector<Action> GetPrincipalVariation() const;
+
+  // Returns the stats of the last search for a move (by GetMove, or a background or
+  // stepped search), or of the pondering that found the move. Calls to
+  // EvaluateStateWithSearch made directly are added to the stats of the last search.
+  // Should not be called while a background search or pondering is running.
+  const SearchStats& GetSearchStats() const;
+
+  // Returns the evaluator that the search uses, e.g. to load its weights. Should not be called
+  // while a background search, stepped search, or pondering is running. If the evaluator's values
+  // are changed through the reference after searching, InvalidateEvaluationCache must be called
+  // before searching again.
+  Evaluator& GetEvaluator();
+
+  // Discards the values in the evaluation cache (see SetEvaluationCacheSize), which were
+  // computed by the evaluator before it was changed. Also cancels the search, and stops
+  // pondering and discards its results, which were found with the old values.
+  void InvalidateEvaluationCache();
+
+  // Sets a stream to write the search stats to after each search for a move, or nullptr
+  // (the default) to not log them.
+  void SetSearchStatsLog(std::ostream* log);
+
+  // Begins a stepped search, which finds the same move as GetMove, but without threads
+  // or recursion: the search keeps its own stack of nodes, so it can be advanced a little
+  // at a time with StepSearch (e.g. once per frame) and then retrieved with
+  // FinishSteppedSearch. Cancels any background search or pondering, and discards any
+  // unfinished stepped search. Throws a runtime_error exception if the game is complete.
+  //
+  // While the stepped search is running, the state stored by the AI is in the middle of
+  // the search, so only the stepped search methods should be called (other methods that
+  // change the state, like UpdateState, discard the stepped search first).
+  void BeginSteppedSearch() override;
+
+  // Advances the stepped search for roughly the given amount of time (at least a few
+  // nodes are always searched), and returns true iff the search is done. Throws a
+  // logic_error exception if no stepped search has been begun.
+  bool StepSearch(std::chrono::milliseconds time_slice) override;
+
+  // Returns true iff a stepped search has been begun and its result not yet retrieved.
+  bool IsSteppedSearchRunning() const override;
+
+  // Returns the move found by the stepped search, and ends it. Throws a logic_error
+  // exception if the stepped search is not done.
+  Action FinishSteppedSearch() override;
+
+  // Updates the state with the given action. Stops pondering first; if the action is an
+  // opponent's move whose best reply was already found by pondering, that reply is kept
+  // for the next call to GetMove.
+  void UpdateState(Action a) override;
+
+  // Stops pondering and resets the state of the game stored by the AI.
+  void ResetState() override;
+
+  // Stops pondering and replaces the state of the game stored by the AI.
+  void SetState(const SuperBoard& state) override;
+
+  // Starts pondering on a background thread: while the opponent is thinking, the AI
+  // goes through the opponent's possible moves (most promising first, according to the
+  // evaluator) and searches for its best reply to each of them, at the depth set by
+  // SetSearchDepth. Does nothing if the game is complete, or if pondering has already
+  // been started in the current state, or if a background or stepped search is running.
+  //
+  // The background thread uses the state stored by the AI, so until pondering is stopped
+  // (which GetMove, UpdateState, ResetState, SetSearchDepth, and StopPondering all do),
+  // no other methods should be called.
+  void StartPondering() override;
+
+  // Stops pondering, and waits for the background thread to finish. Replies found so
+  // far are kept, while the reply that was being searched for is discarded.
+  void StopPondering() override;
+
+  // Returns true iff the background thread is still searching for replies.
+  bool IsPondering() const;
+
+  // Returns true iff the next call to GetMove will return a reply found by pondering.
+  bool HasPonderedReply() const;
   
   // Returns an evaluation in the range [-1, 1]; uses a heuristic to evaluate rather than
   // searching. The evaluation is taken with respect to the active player.
@@ -35,6 +209,9 @@ class TreeSearchAI : public AI {
   //   sub-boards are summed, yielding a value for the given player whose wins are considered above.
   // - This evaluation is done for each player; the value for the active player minus the value for the opponent
   //   is the final state evaluation.
+  //
+  // The search does not call this method, but evaluates states with its Evaluator; HeuristicEvaluator (and so
+  // TreeSearchAI) computes the same values from BitBoards, much faster.
   double EvaluateState() const;
 
   // This method contains most of the logic for the AI's search. Apologies for the long documentation.
@@ -61,34 +238,419 @@ class TreeSearchAI : public AI {
   //     the state without searching any deeper.
   //   - The action in the pair will be a special action {kBoardSize, kBoardSize, kBoardSize, kBoardSize}, and second
   //     field of the pair (the double) will contain the value of the state (either exact, if the state is terminal, 
-  //     or estimated by EvaluateState(), otherwise).
+  //     or estimated by the evaluator, otherwise).
   //   - This format of returning a single "special" action is chosen since there is either no action to take, but we 
   //     still wish to return a state evaluation (if the state is terminal), or we are done searching, and do not want
   //     to consider the actions that can be taken at this state (if depth_to_search is 0), since we would otherwise
   //     be searching an additional level.
   //
   // Evaluation details:
-  //   - Values are in the range [-1, 1], representing whether the state is likely to result in a loss (closer to -1), a 
-  //     win (closer to 1), or a tie (closer to 0).
+  //   - Values are in the range [-kWinValue, kWinValue]. Heuristic values are in (-1, 1), representing whether the
+  //     state is likely to result in a loss (closer to -1), a win (closer to 1), or a tie (closer to 0). Won and lost
+  //     games have values beyond that, which depend on how many plies away the end of the game is (see kWinValue).
   //   - The evaluation is taken with respect to the next player to move (i.e. the active player).
-  //   - State evaluations at search depth 0 are calculated by EvaluateState().
+  //   - State evaluations at search depth 0 are calculated by the Evaluator.
   //
   // Parameters:
   //   - alpha and beta: these define the lower and upper bound of possible state values seen so far, and is used to
-  //     reduce the number of states to search. When calling this method as a user, supply -1 and 1 for alpha and beta 
-  //     respectively, unless you have information on better bounds. For more details, look up alpha-beta pruning.
+  //     reduce the number of states to search. When calling this method as a user, supply -kWinValue and kWinValue
+  //     for alpha and beta respectively, unless you have information on better bounds (e.g. -1 and 1 when only
+  //     heuristic values matter). For more details, look up alpha-beta pruning.
   //   - depth_to_search: controls how many levels are searched. As mentioned above, if this is set to 0, no moves
   //     are searched, and this method enters the special case of not evaluating any actions, just the state. Higher
   //     values of depth_to_search should improve the estimates of action and state values, yielding smarter actions
   //     by the AI, but result in longer computation times due to the increased number of states searched.
+  //
+  // Mate distance pruning: a state that is not terminal cannot be won faster than with the next action, or lost
+  // faster than with the opponent's reply, so the window is narrowed to those values before searching the actions.
+  // If that leaves it empty, a faster win (or slower loss) has already been found elsewhere, and the state is
+  // pruned without searching any action, returning the special action and alpha.
+  //
+  // Move ordering: actions are searched in the order given by OrderActionsByDestination, so that the actions
+  // likeliest to cause a cutoff come first. When several actions are equally good, the first of them in that
+  // order is returned.
+  //
+  // Immediate wins and threats: if the active player can win the game with an action, that action is returned
+  // with the value of winning, without searching the others. With at least 2 levels left, actions that let the
+  // opponent win the game with their reply are not searched (unless every action does). Neither changes the
+  // value returned, since the search would find the same wins and losses.
+  //
+  // Symmetry: if the evaluator is symmetric (see Evaluator::kIsSymmetric) and the state is unchanged by some
+  // of the board's rotations and reflections (like the empty board), actions that they transform into each
+  // other lead to equivalent states, so only the first of them is searched. This changes neither the value
+  // nor the action returned.
+  //
+  // Selective search: if enabled (see SetSelectiveSearch), quiet actions searched late are searched less deeply,
+  // and states near the leaves whose heuristic value is far outside the window are searched less deeply or pruned,
+  // as described in SelectiveSearchSettings. Late move reductions also apply at the top level, but the other
+  // techniques only apply below it, so that there is always an action to return.
+  //
+  // Dead draws (see SuperBoard::IsDeadDraw) below the top level are treated like terminal states
+  // that ended in a tie, with the value 0, since they can only end in a tie.
+  //
+  // Endgames: if the endgame solver is enabled, and the state is not terminal but has few enough
+  // open cells (see SetEndgameSolverThreshold), it is solved exactly by an EndgameSolver instead,
+  // regardless of depth_to_search. The solver's best action is returned, with the value of winning,
+  // drawing, or losing at the end of the solver's line, like a terminal state. If the solver runs
+  // out of nodes, the state is searched as usual, and the solver is not tried again on the states
+  // below it, which have almost as many open cells.
+  //
+  // Frontier: the last kMaxFrontierDepth levels of the search are searched by SearchFrontier, which gives the
+  // same results (and search stats) faster.
+  //
+  // When stop_requested_ is set while this method runs on a background thread (for pondering or for
+  // StartSearch), the search is abandoned and the returned pair is meaningless (it is discarded by the caller).
   pair<Action, double> EvaluateStateWithSearch(double alpha, double beta, size_t depth_to_search);
+
+  // Finds the num_lines best actions in the current state (or all of them, if there are fewer valid
+  // actions), searching each to the given depth. Unlike EvaluateStateWithSearch, the returned values are
+  // exact for every returned action, and each action comes with its principal variation. Lines are
+  // sorted from best to worst; among actions with equal values, the one searched first comes first, so
+  // the first line's action is the move GetMove would play at the same depth.
+  //
+  // Rather than searching every action with the full window, each action is searched with alpha raised
+  // to the value of the num_lines-th best action found so far, so actions that cannot make the list are
+  // pruned like in a normal search. Throws a runtime_error exception if the game is complete, and an
+  // invalid_argument exception if num_lines or depth_to_search is 0.
+  vector<AnalysisLine> EvaluateTopActions(size_t num_lines, size_t depth_to_search);
   
-  // Sets the number of levels to search when GetMove is called.
-  void SetSearchDepth(size_t search_depth);
+  // Sets the number of open cells (see BitBoard::CountOpenCells) at or below which states are
+  // solved exactly by the endgame solver instead of searched (see EvaluateStateWithSearch), or 0
+  // (the default) to never solve them. Also cancels the search, and stops pondering and discards
+  // its results.
+  void SetEndgameSolverThreshold(size_t num_open_cells) override;
+
+  // Sets the node budget of the proof-number search (see ProofNumberSearch) run before searching
+  // for a move, or 0 (the default) to not run it. Also cancels the search, and stops pondering
+  // and discards its results, so that the new budget applies to the next move. The proof search
+  // keeps its table between moves, so once a win is proven, the following moves of the proof
+  // are found again quickly. The stepped search runs the whole proof search in its first step,
+  // so large budgets make that step take longer than requested.
+  void SetProofSearchNodes(size_t max_nodes) override;
+
+  // Sets the opening book to look up moves in before searching, or nullptr (the default) to
+  // always search. Also cancels the search, and stops pondering and discards its results, so that
+  // the next move is looked up in the new book. The book is not owned by the AI, and may be
+  // shared by several AIs; it must stay open until it is no longer set on any AI.
+  void SetOpeningBook(const OpeningBook* opening_book) override;
+
+  // Sets the selective search settings (see SelectiveSearchSettings), which are
+  // SelectiveSearchSettings::Disabled() by default. Also cancels the search, and stops pondering
+  // and discards its results.
+  void SetSelectiveSearch(const SelectiveSearchSettings& settings) override;
+
+  // Sets the number of entries of the evaluation cache (see EvaluationCache), which the leaves
+  // of the search are looked up in before they are evaluated, to 2^size_log2, or disables the
+  // cache if size_log2 is 0. EvaluationCache::kDefaultSizeLog2 by default. The cached values
+  // are those the evaluator would return, so the cache only changes how fast the search is.
+  // Also cancels the search, stops pondering and discards its results, and discards the cached
+  // values. Throws an invalid_argument exception if size_log2 is greater than
+  // EvaluationCache::kMaxSizeLog2.
+  void SetEvaluationCacheSize(size_t size_log2) override;
+
+  // Sets the number of levels to search when GetMove is called. Also cancels the search,
+  // and stops pondering and discards its results, since they were found with the old
+  // search depth.
+  void SetSearchDepth(size_t search_depth) override;
+
+  // Returns true iff the value is that of a won or lost game (see kWinValue), rather than a
+  // heuristic or tied value.
+  static bool IsWinOrLossValue(double value);
+
+  // Returns the number of plies to the end of the game that the given win or loss value was
+  // found with. The return value is undefined if IsWinOrLossValue(value) is false.
+  static size_t GetPliesToEnd(double value);
   
  private:
   size_t search_depth_on_get_move = 5;
 
+  // Pondering state. pondered_replies_ pairs opponent moves with the best reply to
+  // each, and is only accessed by the background thread while it is running.
+  std::thread ponder_thread_;
+  std::atomic<bool> ponder_finished_;
+  vector<pair<Action, Action>> pondered_replies_;
+  bool has_pondered_reply_;
+  Action pondered_reply_;
+
+  std::atomic<size_t> completed_search_depth_;
+
+  const OpeningBook* opening_book_;
+
+  // Cleared at the start of each search for a move, so that searches for the same move (e.g.
+  // by GetMove and by the stepped search) solve the same endgames the same way.
+  EndgameSolver endgame_solver_;
+  size_t endgame_solver_threshold_;
+
+  // The ply of the state that the solver last ran out of nodes on, while the search is still below
+  // that state, or kNoEndgameSolverFailure. The search visits states in depth-first order, so the
+  // next state it visits at that ply or a lower one is outside the failed state's subtree.
+  static constexpr size_t kNoEndgameSolverFailure = static_cast<size_t>(-1);
+  size_t endgame_solver_failed_ply_;
+
+  ProofNumberSearch proof_number_search_;
+  size_t proof_search_nodes_;
+
+  // Set by ProveForcedWin, whose proof search is counted in the stats of the search that follows it
+  // (see BeginSearchStats), or of the pondering whose reply is played (see TakePonderedReply), when
+  // it does not prove a win.
+  bool has_unrecorded_proof_search_;
+  size_t unrecorded_proof_search_nodes_;
+  std::chrono::steady_clock::time_point unrecorded_proof_search_start_time_;
+
+  SelectiveSearchSettings selective_search_;
+
+  // Evaluates the leaves of the search (and the states that selective search and pondering
+  // need a static value for).
+  Evaluator evaluator_;
+
+  // The values of leaves evaluated by earlier searches and iterations, kept between searches
+  // (values only depend on the state).
+  EvaluationCache evaluation_cache_;
+
+  // The number of nodes the stepped search advances by between checks of the clock.
+  static constexpr size_t kNodesPerClockCheck = 64;
+
+  // States with at most this many levels left to search are searched by SearchFrontier.
+  static constexpr size_t kMaxFrontierDepth = 2;
+
+  // Ordering scores used by OrderActionsByDestination (see there), in arbitrary units.
+  static constexpr double kFreeMoveOrderingCost = 4;
+  static constexpr double kOpponentThreatOrderingCost = 2;
+  static constexpr double kCaptureOrderingValue = 1;
+  static constexpr double kOwnThreatOrderingCost = 0.25;
+
+  // A node on the stepped search's stack, holding the local variables of the
+  // corresponding EvaluateStateWithSearch call. Every frame except the bottom one was
+  // entered by playing the action at the parent's next_action.
+  struct SearchFrame {
+    double alpha;
+    double beta;
+    size_t depth_to_search;
+    vector<Action> valid_actions;
+    size_t next_action;
+    Action best_action;
+
+    // Whether futility pruning skips the quiet actions after the first one (see
+    // PrepareSelectiveSearch), and the late move reduction that the action at next_action is
+    // being searched with. The reduction is 0 while the action is searched again at full depth.
+    bool prune_quiet_actions;
+    size_t reduction;
+    bool researching;
+  };
+
+  vector<SearchFrame> search_stack_;
+  bool stepped_search_running_;
+  bool stepped_search_done_;
+  Action stepped_search_result_;
+
+  // Searches the next action of the frame on top of the stack, either evaluating the
+  // resulting state immediately or pushing a frame for it.
+  void AdvanceSteppedSearch();
+
+  // Handles the value (for the active player) of the action being searched in the frame on
+  // top of the stack, updating alpha and ending the frame when it is done or pruned.
+  void ApplySteppedSearchActionValue(double action_value);
+
+  // Pops the frame on top of the stack, whose best action and value are given, and passes
+  // the value to its parent frame (or records the result, if the frame was the bottom one).
+  void FinishSearchFrame(Action best_action, double value);
+
+  // Discards the stepped search, reversing the actions played on the stored state.
+  void AbandonSteppedSearch();
+
+  SearchStats search_stats_;
+  size_t search_ply_;
+  std::chrono::steady_clock::time_point search_start_time_;
+  std::ostream* search_stats_log_;
+
+  // Triangular principal variation table, indexed by ply: while a node at a given ply is being
+  // searched, its entry holds the best line found from that node so far.
+  vector<vector<Action>> principal_variations_;
+
+  // The principal variation returned by GetPrincipalVariation.
+  mutable std::mutex principal_variation_mutex_;
+  vector<Action> principal_variation_;
+
+  // The principal variation of the previous iteration of iterative deepening, whose actions are
+  // searched first, and whether the node being searched is on it (i.e. was reached by playing it).
+  vector<Action> previous_principal_variation_;
+  bool on_previous_principal_variation_;
+
+  // Resets the search stats and starts timing the search. If ProveForcedWin's proof search has run
+  // since the last call, its nodes and time are counted in the search stats.
+  void BeginSearchStats();
+
+  // Records the time elapsed since BeginSearchStats in the search stats.
+  void EndSearchStats();
+
+  // Writes the search stats to the log, if one has been set.
+  void LogSearchStats() const;
+
+  // Clears the best line found from the node at the given ply (making sure the table has entries
+  // for that ply and the next).
+  void ResetPrincipalVariation(size_t ply);
+
+  // Makes the given action, followed by the best line found from the child node, the best line
+  // found from the node at search_ply_.
+  void UpdatePrincipalVariation(const Action& a);
+
+  // Sets the principal variation returned by GetPrincipalVariation. Thread safe.
+  void SetPrincipalVariation(const vector<Action>& principal_variation);
+
+  // If the action of the previous principal variation at search_ply_ is among the given actions,
+  // moves it to the front (keeping the order of the other actions) and returns true.
+  bool MovePreviousPrincipalVariationActionFirst(vector<Action>& actions) const;
+
+  // Orders the valid actions of the state given as the board (keeping the order of actions with equal
+  // scores) by a cheap static score that is only meant for move ordering. A move's quality
+  // is mostly decided by where it sends the opponent (the destination sub-board, given by
+  // row_in_subboard and col_in_subboard):
+  //   - Sending the opponent to a complete sub-board gives them a free move anywhere, which
+  //     is the worst case.
+  //   - Sending them to a sub-board where they have two in a line (with the third cell empty)
+  //     lets them win it right away.
+  //   - Sending them to a sub-board where this AI's player has two in a line lets them block
+  //     it, which is slightly bad.
+  // Moves that win the sub-board they are played on also score higher.
+  void OrderActionsByDestination(const BitBoard& board, vector<Action>& actions) const;
+
+  // Returns the valid actions of the state given as the board to search with
+  // depth_to_search levels left, in the order given by OrderActionsByDestination. If the state
+  // and the evaluator are symmetric, only the first of each set of equivalent actions (in the order of
+  // GetValidActions) is kept. With at least 2 levels left, the actions after which the
+  // opponent can win the game right away are also left out (unless every action is), since
+  // searching them would only find that they lose.
+  vector<Action> GetActionsToSearch(const BitBoard& board, size_t depth_to_search);
+
+  // If the player to move in the state given as the board can win the game with
+  // their next action, sets winning_action to it and returns true. This takes constant time
+  // (see BitBoard::FindWinningMove).
+  bool FindImmediateWin(const BitBoard& board, Action& winning_action);
+
+  // If the opening book has a move for the current state (see GetMove), sets move to it and
+  // returns true. The search stats are reset and the principal variation is set to the move.
+  bool ProbeOpeningBook(Action& move);
+
+  // If the proof search is enabled and proves that the player to move can force a win (see
+  // GetMove), sets move to the first move of the proof and returns true. The search stats are
+  // reset to those of the proof search, and the principal variation is set to the move.
+  // Otherwise, the proof search is counted in the stats of the search that follows.
+  bool ProveForcedWin(Action& move);
+
+  // If pondering found the best reply to the opponent's last move (see GetMove), sets move to it
+  // and returns true. The search stats are left as those of the pondering, with ProveForcedWin's
+  // proof search added to them if it has run since, and the principal variation is set to the move.
+  bool TakePonderedReply(Action& move);
+
+  // Applies the selective search techniques that are decided before searching the actions of a
+  // state below the top level (see SelectiveSearchSettings), given the state's window. Returns
+  // true iff the state is pruned by futility pruning, setting value to its value. Otherwise,
+  // razoring may reduce depth_to_search, and prune_quiet_actions is set iff futility pruning
+  // skips the quiet actions after the first one.
+  // The board is the state (which is not state_ when it is searched by SearchFrontier).
+  bool PrepareSelectiveSearch(const BitBoard& board, double alpha, double beta, size_t& depth_to_search,
+                              bool& prune_quiet_actions, double& value);
+
+  // Returns the number of levels by which the action at the given index (in the order searched)
+  // of a state with depth_to_search levels left is reduced by late move reductions.
+  size_t GetLateMoveReduction(size_t depth_to_search, size_t action_index, bool is_quiet) const;
+
+  // Plays the action on the stored state, or reverses the last action played, keeping the
+  // evaluator up to date. Searches play and reverse actions with these methods.
+  void PlaySearchAction(const Action& a);
+  void ReverseSearchAction();
+
+  // Returns true iff the action, which was just played, did not complete its sub-board. The
+  // second overload takes the state after the action as a BitBoard, rather than the current state.
+  bool IsQuietAction(const Action& a) const;
+  static bool IsQuietAction(const BitBoard& board, const Action& a);
+
+  // If the current state is an endgame that the solver should solve (see EvaluateStateWithSearch),
+  // and it is solved within the solver's node budget, sets action_and_value to the best action and
+  // its value, and returns true.
+  // The state is search_ply plies from the state the search started from.
+  bool SolveEndgame(size_t search_ply, pair<Action, double>& action_and_value);
+
+  // Same as SolveEndgame, for the given state rather than the current one.
+  bool SolveEndgame(const BitBoard& board, size_t search_ply, pair<Action, double>& action_and_value);
+
+  // Returns true iff SolveEndgame would try to solve the given state, search_ply plies from the
+  // state the search started from.
+  bool ShouldSolveEndgame(const BitBoard& board, size_t search_ply) const;
+
+  // Clears the endgame solver's table and failures, at the start of a search.
+  void ClearEndgameSolver();
+
+  // Returns evaluator_'s value of the state, from the evaluation cache if it has it, and
+  // otherwise stores it there.
+  double EvaluateLeaf(const BitBoard& board);
+
+  // Same as EvaluateStateWithSearch, for a state with kDepth levels left to search (at most
+  // kMaxFrontierDepth), given as a BitBoard. Since the last levels of the search have most of
+  // its nodes, they are searched on copies of BitBoards instead of playing and reversing
+  // moves on the SuperBoard, and their leaves are evaluated by evaluator_; the depth is a
+  // template parameter, so each level is a separate function, and the leaves
+  // (SearchFrontier<0>) are inlined into the loop over the actions of the level above. The
+  // nodes are searched, and counted in the search stats, exactly as EvaluateStateWithSearch
+  // would, and search_ply_ is kept up to date in the same way.
+  //
+  // The depth is passed as a FrontierDepth tag, so that the leaves can be a plain overload (a
+  // member template of a class template cannot be specialized on its own).
+  template <size_t kDepth>
+  using FrontierDepth = std::integral_constant<size_t, kDepth>;
+  template <size_t kDepth>
+  pair<Action, double> SearchFrontier(const BitBoard& board, double alpha, double beta, FrontierDepth<kDepth>);
+  pair<Action, double> SearchFrontier(const BitBoard& board, double alpha, double beta, FrontierDepth<0>);
+
+  // Searches the actions of a state for SearchFrontier, searching each child kChildDepth levels
+  // deep. depth_to_search is the state's number of levels left (kChildDepth + 1, unless
+  // razoring reduced it), and prune_quiet_actions is set by PrepareSelectiveSearch.
+  //
+  // The children are searched one at a time, or, when they are leaves and the evaluator prefers
+  // batches, evaluated in batches (see below). Which one is passed as a BatchesChildren tag
+  // rather than tested, so that the batched search, and with it Evaluator::EvaluateBatch, is only
+  // instantiated for evaluators that prefer batches.
+  template <size_t kChildDepth>
+  using BatchesChildren = std::integral_constant<bool, kChildDepth == 0 && Evaluator::kPrefersBatches>;
+  template <size_t kChildDepth>
+  pair<Action, double> SearchFrontierActions(const BitBoard& board, double alpha, double beta, size_t depth_to_search,
+                                             bool prune_quiet_actions, std::false_type);
+
+  // How the batched SearchFrontierActions finds the value of a child.
+  enum class FrontierLeaf : uint8_t {
+    kPruned,     // Left out by futility pruning
+    kTerminal,   // The game is complete or a dead draw
+    kSearched,   // Searched by SearchFrontier (the first child, and those the endgame solver may solve)
+    kCached,     // Found in the evaluation cache
+    kEvaluated   // Evaluated in the batch
+  };
+
+  // SearchFrontierActions for kChildDepth = 0 with batches, where every child is a leaf. The
+  // first child is searched on its own, since it often causes a beta cutoff. If it does not, the
+  // other children that need evaluating are put in a PositionBatch and evaluated together by
+  // evaluator_.EvaluateBatch (see PrepareFrontierLeaves). The children are then visited in order
+  // as SearchFrontier would visit them, counting the same stats, with the values found. Children
+  // after a later beta cutoff are evaluated for nothing, which is the cost of batching.
+  template <size_t kChildDepth>
+  pair<Action, double> SearchFrontierActions(const BitBoard& board, double alpha, double beta, size_t depth_to_search,
+                                             bool prune_quiet_actions, std::true_type);
+
+  // Sets leaves[i] to how the value of the child reached by valid_actions[i] is found, for every
+  // i > 0, and leaf_values[i] to the value of the terminal, cached, and batch evaluated children,
+  // which are evaluated by evaluator (always evaluator_) and stored in the evaluation cache. The
+  // evaluator is a template argument so that, like the batched SearchFrontierActions, this is
+  // only instantiated for evaluators that prefer batches.
+  template <typename BatchEvaluator>
+  void PrepareFrontierLeaves(const BatchEvaluator& evaluator, const BitBoard& board,
+                             const vector<Action>& valid_actions, bool prune_quiet_actions, FrontierLeaf* leaves,
+                             double* leaf_values);
+
+  // Runs on the background thread started by StartPondering.
+  void Ponder();
+
+  // Runs on the background thread started by StartSearch.
+  Action SearchInBackground() override;
+
   // Returns a vector of valid actions in the current state.
   vector<Action> GetValidActions() const;
   
@@ -154,8 +716,16 @@ class TreeSearchAI : public AI {
   double TwoDimVectorDotProduct(const vector<vector<double>>& v1, const vector<vector<double>>& v2) const;
   
   // Gets the confirmed (non-heuristic) value of the state for the active player, assuming
-  // the game is over. The return value is undefined if the game is not complete.
-  double GetEndOfGameEvaluation() const;
+  // the game is over (or is a dead draw), and that the state is search_ply plies from the
+  // state the search started from (see kWinValue). The return value is undefined if the game
+  // is not complete.
+  double GetEndOfGameEvaluation(size_t search_ply) const;
+
+  // Same as GetEndOfGameEvaluation, for the given state rather than the current one.
+  static double GetEndOfGameEvaluation(const BitBoard& board, size_t search_ply);
+
+  // Returns the value of winning the game search_ply plies from the state the search started from.
+  static double GetWinValue(size_t search_ply);
   
   // Takes in an evaluation score in the range (-inf, inf) and rescales it to
   // (-1, 1) to make it a proper state or action value. This rescaling uses 
@@ -166,4 +736,14 @@ class TreeSearchAI : public AI {
   double RescaleEvaluation(double evaluation_score) const;
 };
 
+// The tree search AI with the heuristic of EvaluateState.
+using TreeSearchAI = BasicTreeSearchAI<HeuristicEvaluator>;
+
+// Returns a new tree search AI that uses the given evaluator, for choosing the evaluator at
+// runtime. Evaluators with learned weights (kNeural and kPattern) load them from the file with
+// the given path (see NeuralEvaluator::Load and PatternEvaluator::Load), which other evaluators
+// ignore. Throws an invalid_argument exception if the evaluator type is unknown, and a
+// runtime_error exception if the weights cannot be loaded.
+std::unique_ptr<SearchAI> MakeTreeSearchAI(EvaluatorType evaluator_type, const string& weights_path = "");
+
 }  // namespace ultimate_tictactoe
\ No newline at end of file
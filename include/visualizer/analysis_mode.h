@@ -0,0 +1,17 @@
+#pragma once
+
+namespace ultimate_tictactoe {
+
+namespace visualizer {
+
+// What the analysis engine's output is used for during the game: nothing, the best lines
+// in the info panel, or the best lines plus a heatmap of every valid move's value on the board.
+enum class AnalysisMode {
+  kOff,
+  kLines,
+  kHeatmap
+};
+
+}  // namespace visualizer
+
+}  // namespace ultimate_tictactoe
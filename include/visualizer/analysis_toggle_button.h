@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "cinder/gl/gl.h"
+#include <visualizer/analysis_mode.h>
+#include <visualizer/button.h>
+
+namespace ultimate_tictactoe {
+
+namespace visualizer {
+
+using std::string;
+using ci::vec2;
+
+class AnalysisToggleButton : public Button {
+ public:
+  const string kButtonTitle = "Engine Analysis";
+  const float kTitleOffset = -100;
+
+  AnalysisToggleButton(vec2 kTopLeft, vec2 kBottomRight, ci::Color kButtonColor, ci::Color kButtonColorDark);
+
+  // Draws the analysis button, but does not handle inputs, other than visually responding to mouse hover-overs.
+  void DrawAnalysisToggleButtonAndText(const vec2& mouse_pos, AnalysisMode analysis_mode) const;
+};
+
+}  // namespace visualizer
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include "cinder/gl/gl.h"
+#include <core/action.h>
+#include <core/analysis_engine.h>
+#include <core/superboard.h>
+
+namespace ultimate_tictactoe {
+
+namespace visualizer {
+
+using std::string;
+using ci::vec2;
+
+// Shows the analysis engine's output in the info panel: the search depth and speed,
+// followed by one row per line (up to kMaxLinesShown), with the line's value and principal variation.
+class AnalysisView {
+ public:
+  const vec2 kAnalysisTopLeft = {1225, 130};
+  const float kRowHeight = 40;
+  const size_t kMaxLinesShown = 10;
+  const size_t kMaxMovesShownPerLine = 5;
+  const ci::Color kFontColor = ci::Color::black();
+  const ci::Font kFont = ci::Font("Roboto", 20);
+
+  // Draws the given analysis of the given board. Values are shown from Player 1's point of view
+  // (positive is good for Player 1), and moves are written as sub-board/cell, where sub-boards and
+  // cells are both numbered 1-9 in reading order. If the analysis is not of the given board, or no
+  // analysis has been done yet (depth 0), only a placeholder is shown.
+  void DrawAnalysis(const SuperBoard& board_, const AnalysisInfo& analysis, size_t position_id) const;
+
+ private:
+  // Writes the action in the sub-board/cell notation described above.
+  string ActionToString(const Action& a) const;
+};
+
+}  // namespace visualizer
+
+}  // namespace ultimate_tictactoe
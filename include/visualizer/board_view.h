@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include "cinder/gl/gl.h"
+#include <core/analysis_line.h>
 #include <visualizer/completion_stage.h>
 
 namespace ultimate_tictactoe {
@@ -9,6 +12,7 @@ namespace visualizer {
   
 using ci::vec2;
 using ci::ivec2;
+using std::vector;
 
 class BoardView {
  public:
@@ -36,10 +40,17 @@ class BoardView {
   const ci::Color kSubBoardTieColor = ci::Color::gray(0.75);
   const ci::Color kSubBoardAvailableColor = ci::Color(255/255.0f, 255/255.0f, 0/255.0f); // Yellow
   const ci::Color kSubBoardAvailableColorLight = ci::Color(255/255.0f, 255/255.0f, 141/255.0f); // Shade of yellow
+
+  // Used for the move score heatmap, for the best and worst moves respectively
+  const ci::Color kHeatmapBestColor = ci::Color(102/255.0f, 194/255.0f, 120/255.0f); // Shade of green
+  const ci::Color kHeatmapWorstColor = ci::Color(120/255.0f, 120/255.0f, 120/255.0f); // Shade of gray
+  const float kHeatmapCellMargin = 2;
   
   // Draws the board, with its grid, sub-board grids, marks played, and any highlighting for the required sub-board
-  // and hover-over for the grid that the mouse is on.
-  void DrawSuperBoard(const SuperBoard& board_, const vec2& mouse_pos, CompletionStage completion_stage_, bool current_player_is_human) const;
+  // and hover-over for the grid that the mouse is on. If move_scores is not empty, each scored move's cell is
+  // shaded by its score, as a heatmap (see DrawMoveScores).
+  void DrawSuperBoard(const SuperBoard& board_, const vec2& mouse_pos, CompletionStage completion_stage_, bool current_player_is_human,
+                      const vector<AnalysisLine>& move_scores) const;
   
   // Returns the Action corresponding to the grid square that the mouse is on.
   //
@@ -71,6 +82,11 @@ class BoardView {
   // just that one; if any sub-boards are allowed, it highlights any sub-boards that still may be played on.
   void DrawAvailableSubBoardIndicator(const SuperBoard& board_) const;
 
+  // Shades the cell of each move by its value, from kHeatmapWorstColor for the lowest value to kHeatmapBestColor
+  // for the highest. The colors are scaled to the range of the values, since the values of shallow searches are
+  // often close together.
+  void DrawMoveScores(const vector<AnalysisLine>& move_scores) const;
+
   // Draws a grid, either for the super-board or for the sub-board.
   //
   // DrawGrid remains a bit more low-level (still having vec2 parameters representing pixel locations) than the others
@@ -79,6 +95,9 @@ class BoardView {
   
   // Draws a mark in the location specified by the action, and with the provided color.
   void DrawMark(const Action& a, const ci::Color& color) const;
+
+  // Computes the rectangle covering the grid square of the given action, shrunk by the given margin on each side.
+  ci::Rectf GetCellRect(const Action& a, float margin) const;
   
   // Draws the lightly shaded mark where the player's cursor is, if the player is human (with the color corresponding
   // to the active player).
@@ -3,7 +3,11 @@
 #include <string>
 
 #include "cinder/gl/gl.h"
+#include <core/analysis_engine.h>
 #include <core/superboard.h>
+#include <visualizer/analysis_mode.h>
+#include <visualizer/analysis_toggle_button.h>
+#include <visualizer/analysis_view.h>
 #include <visualizer/completion_stage.h>
 #include <visualizer/game_completion_message_view.h>
 #include <visualizer/start_or_reset_button.h>
@@ -33,6 +37,12 @@ class InfoPanelView {
   const ci::Color kP2AIToggleButtonColorDark = ci::Color(56 / 255.0f, 147 / 255.0f, 192 / 255.0f);
   const string kP1AIToggleButtonTitle = "Player 1 Select";
   const string kP2AIToggleButtonTitle = "Player 2 Select";
+
+  // Parameters for initializing the analysis toggle button
+  const vec2 kAnalysisToggleButtonTopLeft = {1250, 600};
+  const vec2 kAnalysisToggleButtonBottomRight = {1550, 700};
+  const ci::Color kAnalysisToggleButtonColor = ci::Color::gray(0.65);
+  const ci::Color kAnalysisToggleButtonColorDark = ci::Color::gray(0.55);
   
   // Parameters for initializing the start/reset button
   const vec2 kStartOrResetButtonTopLeft = {1250, 750};
@@ -43,9 +53,11 @@ class InfoPanelView {
   InfoPanelView();
 
   // Draws the info panel, together with all its buttons. Elements on the info panel may respond to
-  // mouse movements visually, but otherwise do not do any processing from the inputs.
+  // mouse movements visually, but otherwise do not do any processing from the inputs. Unless
+  // analysis mode is off, the latest analysis is shown while the game is in progress (see AnalysisView).
   void DrawInfoPanel(const SuperBoard& board_, const vec2& mouse_pos, const CompletionStage& completion_stage_,
-                     bool p1_is_AI, bool p2_is_AI);
+                     bool p1_is_AI, bool p2_is_AI, AnalysisMode analysis_mode, const AnalysisInfo& analysis,
+                     size_t position_id);
 
   // Returns true iff the mouse is on the start/reset game button.
   bool MouseIsOnStartOrResetGameButton(const vec2& mouse_pos);
@@ -60,10 +72,16 @@ class InfoPanelView {
   // in the game setup stage).
   bool MouseIsOnP2AIToggleButton(const vec2& mouse_pos);
 
+  // Returns true iff the mouse is on the analysis toggle button, regardless of whether
+  // the button is being displayed or not (this button only shows up in the game setup stage).
+  bool MouseIsOnAnalysisToggleButton(const vec2& mouse_pos);
+
  private:
   GameCompletionMessageView game_completion_message_view_;
   AIToggleButton P1_AI_toggle_button_;
   AIToggleButton P2_AI_toggle_button_;
+  AnalysisToggleButton analysis_toggle_button_;
+  AnalysisView analysis_view_;
   StartOrResetButton start_or_reset_button_;
 };
 
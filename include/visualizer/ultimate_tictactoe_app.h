@@ -1,10 +1,18 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+
 #include "cinder/app/App.h"
 #include "cinder/app/RendererGl.h"
 #include "cinder/gl/gl.h"
+#include <core/analysis_engine.h>
+#include <core/opening_book.h>
 #include <core/superboard.h>
 #include <core/ai.h>
+#include <core/evaluator_type.h>
+#include <core/search_ai.h>
+#include <visualizer/analysis_mode.h>
 #include <visualizer/completion_stage.h>
 #include <visualizer/info_panel_view.h>
 #include <visualizer/board_view.h>
@@ -25,8 +33,11 @@ class UltimateTicTacToeApp : public ci::app::App {
   // Draws the board and the info panel (together with the buttons).
   void draw() override;
   
-  // Is only needed to query and play AI moves, once it is the AI's turn. Button
-  // presses and user inputs are handled in the mouseDown method.
+  // Is only needed to query and play AI moves, once it is the AI's turn, and to let
+  // the AI ponder while a human is to move. AI moves are searched for in the background
+  // (or, in single-threaded builds, a time slice at a time), so that the window stays
+  // responsive. Button presses and user inputs are handled
+  // in the mouseDown method.
   void update() override;
   
   // Handles button clicks, and updates the fields accordingly (e.g. board state).
@@ -34,14 +45,34 @@ class UltimateTicTacToeApp : public ci::app::App {
 
   const vec2 kWindowSize = {1800, 1000};
 
+  // How long to advance the AI's search by each frame in single-threaded builds.
+  const std::chrono::milliseconds kAISearchTimeSlice = std::chrono::milliseconds(8);
+
+  // The opening book that the AIs use, if it exists (it is built by the book builder app).
+  const std::string kOpeningBookPath = "opening_book.bin";
+
+  // The number of lines analyzed when the analysis mode does not need every move's value.
+  const size_t kNumAnalysisLines = 3;
+
+  // The evaluator that the AIs' searches use (see MakeTreeSearchAI), and the file its weights
+  // are loaded from, if it has any. If they cannot be loaded, the AIs use the heuristic evaluator.
+  const EvaluatorType kAIEvaluator = EvaluatorType::kHeuristic;
+  const std::string kEvaluatorWeightsPath = "evaluator_weights.bin";
+
  private:
   // Model variables
-  // Not exactly sure how to make a generic AI reference field and set it
-  // to a TreeSearchAI object (getting issues about l-value references binding
-  // to temporaries), so I'm having these just be TreeSearchAI objects.
   SuperBoard board_;
-  TreeSearchAI p1_AI_;
-  TreeSearchAI p2_AI_;
+
+  // Declared before the AIs, since they use it until they are destroyed.
+  OpeningBook opening_book_;
+  std::unique_ptr<SearchAI> p1_AI_;
+  std::unique_ptr<SearchAI> p2_AI_;
+
+  // Unless analysis mode is off, the engine analyzes the displayed board during the game,
+  // and analysis_ holds its latest output for the position with ID analysis_position_id_.
+  AnalysisEngine analysis_engine_;
+  AnalysisInfo analysis_;
+  size_t analysis_position_id_;
   
   // View variables
   BoardView board_view_;
@@ -51,12 +82,19 @@ class UltimateTicTacToeApp : public ci::app::App {
   CompletionStage completion_stage_;
   bool p1_is_AI_;
   bool p2_is_AI_;
+  AnalysisMode analysis_mode_;
   
   // Updates the state of the displayed board, as well as each of the AI's stored
   // board states. Crashes if the action is invalid for any of the states (AI
   // states should be identical to the displayed board state, however).
   void UpdateGameAndAIBoards(const Action& a);
   
+  // Starts the given AI's search if it has not been started yet, and plays the AI's
+  // move once the search is done. Called once per frame. In single-threaded builds,
+  // the search is advanced by kAISearchTimeSlice per call; otherwise it runs on a
+  // background thread and is only polled.
+  void UpdateAISearch(SearchAI& ai);
+
   // Resets the state of the displayed board and the board states stored by the
   // AIs.
   void ResetGameAndAIBoards();
@@ -75,6 +113,11 @@ class UltimateTicTacToeApp : public ci::app::App {
   // fields according to the mouse inputs (as noted above, only takes into account
   // the mouse position, not whether a click has actually occurred).
   void HandleAIToggleButtonClick(cinder::app::MouseEvent event);
+
+  // If the game has not yet been started, switches to the next analysis mode if the
+  // mouse is over the analysis toggle button. With SINGLE_THREADED_AI, analysis stays off,
+  // since the analysis engine searches on a background thread.
+  void HandleAnalysisToggleButtonClick(cinder::app::MouseEvent event);
   
   // If the game has not yet been started, starts the game if the mouse is over
   // the start game button. If the game is in progress or is complete, returns
@@ -1,6 +1,15 @@
+#include <chrono>
+#include <stdexcept>
+
 #include <core/ai.h>
 
 namespace ultimate_tictactoe {
+
+AI::AI() : stop_requested_(false), has_best_move_so_far_(false), best_move_so_far_{0, 0, 0, 0} {}
+
+AI::~AI() {
+  CancelSearch();
+}
   
 Action AI::GetMove() {
   for (size_t row_in_board = 0; row_in_board < state_.kBoardSize; row_in_board++) {
@@ -19,11 +28,87 @@ Action AI::GetMove() {
 }
 
 void AI::UpdateState(Action a) {
+  CancelSearch();
   state_.PlayMove(a);
 }
 
 void AI::ResetState() {
+  CancelSearch();
   state_ = SuperBoard();
 }
 
+void AI::SetState(const SuperBoard& state) {
+  CancelSearch();
+  state_ = state;
+}
+
+std::shared_future<Action> AI::StartSearch() {
+  CancelSearch();
+  stop_requested_ = false;
+  {
+    std::lock_guard<std::mutex> lock(best_move_so_far_mutex_);
+    has_best_move_so_far_ = false;
+  }
+  search_ = std::async(std::launch::async, &AI::SearchInBackground, this).share();
+  return search_;
+}
+
+bool AI::IsSearching() const {
+  return search_.valid();
+}
+
+bool AI::IsSearchDone() const {
+  return !search_.valid() || search_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void AI::RequestStop() {
+  stop_requested_ = true;
+}
+
+void AI::ClearStopRequest() {
+  stop_requested_ = false;
+}
+
+Action AI::GetBestMoveSoFar() const {
+  std::lock_guard<std::mutex> lock(best_move_so_far_mutex_);
+  if (!has_best_move_so_far_) {
+    throw std::runtime_error("The search has not found a move yet.");
+  }
+  return best_move_so_far_;
+}
+
+Action AI::FinishSearch() {
+  if (!search_.valid()) {
+    throw std::logic_error("No search has been started, so there is no move to retrieve.");
+  }
+
+  // Clear the search before retrieving the move, since retrieving it may rethrow an exception.
+  std::shared_future<Action> search = search_;
+  search_ = std::shared_future<Action>();
+  search.wait();
+  stop_requested_ = false;
+  return search.get();
+}
+
+void AI::CancelSearch() {
+  if (search_.valid()) {
+    stop_requested_ = true;
+    search_.wait();
+    search_ = std::shared_future<Action>();
+    stop_requested_ = false;
+  }
+}
+
+Action AI::SearchInBackground() {
+  Action a = GetMove();
+  SetBestMoveSoFar(a);
+  return a;
+}
+
+void AI::SetBestMoveSoFar(Action a) {
+  std::lock_guard<std::mutex> lock(best_move_so_far_mutex_);
+  has_best_move_so_far_ = true;
+  best_move_so_far_ = a;
+}
+
 }  // namespace ultimate_tictactoe
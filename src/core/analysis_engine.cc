@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <utility>
+
+#include <core/analysis_engine.h>
+
+namespace ultimate_tictactoe {
+
+constexpr size_t AnalysisEngine::kMaxDepth;
+constexpr size_t AnalysisEngine::kAllLines;
+constexpr size_t AnalysisEngine::kMaxCachedPositions;
+constexpr size_t AnalysisEngine::kProofSearchNodesPerDepth;
+constexpr size_t AnalysisEngine::kPositionChannelCapacity;
+constexpr size_t AnalysisEngine::kAnalysisChannelCapacity;
+
+AnalysisEngine::AnalysisEngine(size_t num_lines) : num_lines_(num_lines), stop_requested_(false),
+                                                   position_changed_(false), latest_position_id_(0),
+                                                   has_pending_position_(false),
+                                                   pending_position_{0, SuperBoard(), num_lines, 0},
+                                                   latest_position_hash_(0), latest_num_lines_needed_(0),
+                                                   has_new_analysis_(false) {
+  ai_.SetEndgameSolverThreshold(TreeSearchAI::kSuggestedEndgameSolverThreshold);
+}
+
+AnalysisEngine::~AnalysisEngine() {
+  Stop();
+}
+
+void AnalysisEngine::Start() {
+  if (thread_.joinable()) {
+    return;
+  }
+  stop_requested_ = false;
+  thread_ = std::thread(&AnalysisEngine::Run, this);
+}
+
+void AnalysisEngine::Stop() {
+  if (thread_.joinable()) {
+    stop_requested_ = true;
+    ai_.RequestStop();
+    thread_.join();
+  }
+}
+
+bool AnalysisEngine::IsRunning() const {
+  return thread_.joinable();
+}
+
+size_t AnalysisEngine::SetPosition(const SuperBoard& board) {
+  latest_position_id_++;
+  BitBoard bit_board(board);
+  latest_position_hash_ = bit_board.GetHash();
+  latest_num_lines_needed_ = std::min(num_lines_, bit_board.CountValidMoves());
+
+  size_t completed_depth = 0;
+  std::unordered_map<uint64_t, AnalysisInfo>::const_iterator cached = analysis_cache_.find(latest_position_hash_);
+  has_new_analysis_ = (cached != analysis_cache_.end() && IsCachedAnalysisUsable(cached->second));
+  if (has_new_analysis_) {
+    completed_depth = cached->second.depth;
+  }
+
+  pending_position_ = {latest_position_id_, board, num_lines_, completed_depth};
+  has_pending_position_ = true;
+  SendPendingPosition();
+  return latest_position_id_;
+}
+
+void AnalysisEngine::SetNumLines(size_t num_lines) {
+  num_lines_ = num_lines;
+}
+
+bool AnalysisEngine::PollAnalysis(AnalysisInfo& analysis) {
+  SendPendingPosition();
+
+  AnalysisInfo newest_analysis;
+  while (analyses_.TryPop(newest_analysis)) {
+    if (newest_analysis.position_id != latest_position_id_) {
+      continue;
+    }
+
+    std::unordered_map<uint64_t, AnalysisInfo>::iterator cached = analysis_cache_.find(latest_position_hash_);
+    if (cached == analysis_cache_.end()) {
+      if (analysis_cache_.size() >= kMaxCachedPositions) {
+        analysis_cache_.clear();
+      }
+      analysis_cache_[latest_position_hash_] = std::move(newest_analysis);
+    } else if (!IsCachedAnalysisUsable(cached->second) || newest_analysis.depth >= cached->second.depth) {
+      cached->second = std::move(newest_analysis);
+    }
+    has_new_analysis_ = true;
+  }
+
+  if (!has_new_analysis_) {
+    return false;
+  }
+  has_new_analysis_ = false;
+  analysis = analysis_cache_[latest_position_hash_];
+  analysis.position_id = latest_position_id_;
+  return true;
+}
+
+bool AnalysisEngine::IsCachedAnalysisUsable(const AnalysisInfo& analysis) const {
+  return analysis.lines.size() >= latest_num_lines_needed_;
+}
+
+void AnalysisEngine::SendPendingPosition() {
+  if (has_pending_position_ && positions_.TryPush(pending_position_)) {
+    has_pending_position_ = false;
+
+    // The flag must be set after the push, so that the background thread cannot clear it
+    // without also seeing the new position.
+    position_changed_ = true;
+    ai_.RequestStop();
+  }
+}
+
+void AnalysisEngine::Run() {
+  Position position = {0, SuperBoard(), 0, 0};
+  bool has_position = false;
+  size_t completed_depth = 0;
+  ProofResult forced_win = ProofResult::kUnknown;
+  Action forced_win_move = {0, 0, 0, 0};
+
+  while (!stop_requested_) {
+    // Clear the flags before checking for a new position; a position sent after this point
+    // sets them again, which abandons the search below.
+    position_changed_ = false;
+    ai_.ClearStopRequest();
+    if (positions_.TryPopLatest(position)) {
+      has_position = true;
+      completed_depth = position.completed_depth;
+      forced_win = ProofResult::kUnknown;
+      ai_.SetState(position.board);
+    }
+
+    if (!has_position || position.board.IsComplete() || completed_depth == kMaxDepth) {
+      std::this_thread::sleep_for(kIdleSleepTime);
+      continue;
+    }
+
+    if (forced_win == ProofResult::kUnknown) {
+      forced_win = proof_number_search_.ProveWin(position.board, kProofSearchNodesPerDepth, forced_win_move);
+    }
+    vector<AnalysisLine> lines = ai_.EvaluateTopActions(position.num_lines, completed_depth + 1);
+    if (position_changed_ || stop_requested_) {
+      continue;
+    }
+    completed_depth++;
+
+    const SearchStats& stats = ai_.GetSearchStats();
+    AnalysisInfo analysis = {position.id, completed_depth, lines, forced_win, forced_win_move, stats.nodes,
+                             stats.GetNodesPerSecond()};
+
+    // If the consumer has fallen behind, this update is dropped rather than waiting for space.
+    analyses_.TryPush(analysis);
+  }
+}
+
+}  // namespace ultimate_tictactoe
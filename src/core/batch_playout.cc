@@ -0,0 +1,219 @@
+#include <algorithm>
+
+#include <core/batch_playout.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+// Cell indices of each row, column, and diagonal, used for both sub-board and game wins.
+const size_t kLines[8][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8},
+                             {0, 3, 6}, {1, 4, 7}, {2, 5, 8},
+                             {0, 4, 8}, {2, 4, 6}};
+
+size_t PopCount64(uint64_t lanes) {
+  return PopCount(static_cast<uint32_t>(lanes)) + PopCount(static_cast<uint32_t>(lanes >> 32));
+}
+
+// Returns the mask of lanes in which the given bit-sliced 3x3 grid has a full line.
+uint64_t LanesWithLine(const uint64_t grid[]) {
+  uint64_t lanes = 0;
+  for (const size_t* line : kLines) {
+    lanes |= grid[line[0]] & grid[line[1]] & grid[line[2]];
+  }
+  return lanes;
+}
+
+// Random elimination: while a lane has more than one candidate, each of its candidates
+// survives with probability 1/2 (one random bit per lane per candidate). If none of a
+// lane's candidates survive, that lane's round is discarded. Since candidates are
+// treated symmetrically, each lane's last remaining candidate is uniformly random.
+//
+// Lanes with a single candidate are settled and are never touched again, so each
+// round only looks at the candidates of some contested lane (kept as a compacted
+// list of indices). Each round takes two passes: one to draw the random bits, and
+// one to apply them and find the lanes that are still contested.
+void ReduceToSingleRandomCandidate(uint64_t candidates[], size_t num_candidates, XorShiftRandom& random) {
+  size_t live[BitBoard::kNumCells];
+  size_t num_live = 0;
+  uint64_t lanes_with_candidate = 0;
+  uint64_t contested_lanes = 0;
+  for (size_t i = 0; i < num_candidates; i++) {
+    contested_lanes |= lanes_with_candidate & candidates[i];
+    lanes_with_candidate |= candidates[i];
+    if (candidates[i] != 0) {
+      live[num_live++] = i;
+    }
+  }
+
+  uint64_t random_bits[BitBoard::kNumCells];
+  while (contested_lanes != 0) {
+    size_t num_contested = 0;
+    uint64_t lanes_with_survivor = 0;
+    for (size_t i = 0; i < num_live; i++) {
+      if (candidates[live[i]] & contested_lanes) {
+        live[num_contested] = live[i];
+        random_bits[num_contested] = random.Next();
+        lanes_with_survivor |= candidates[live[i]] & random_bits[num_contested];
+        num_contested++;
+      }
+    }
+    num_live = num_contested;
+
+    uint64_t eliminating_lanes = contested_lanes & lanes_with_survivor;
+    lanes_with_candidate = 0;
+    uint64_t still_contested_lanes = 0;
+    for (size_t i = 0; i < num_live; i++) {
+      uint64_t& lanes = candidates[live[i]];
+      lanes &= ~eliminating_lanes | random_bits[i];
+      still_contested_lanes |= lanes_with_candidate & lanes;
+      lanes_with_candidate |= lanes;
+    }
+    contested_lanes &= still_contested_lanes;
+  }
+}
+
+}  // namespace
+
+constexpr size_t BatchPlayout::kLanes;
+constexpr size_t BatchPlayout::kNumCells;
+
+BatchPlayout::BatchPlayout(uint64_t seed) : active_lanes_(0), current_player_(0), random_(seed) {}
+
+PlayoutCounts BatchPlayout::Play(const BitBoard& board, size_t num_playouts) {
+  PlayoutCounts counts = {0, 0, 0};
+  size_t starting_player = (board.GetCurrentPlayer() == Player::kPlayer1 ? 0 : 1);
+
+  for (size_t playouts_started = 0; playouts_started < num_playouts; playouts_started += kLanes) {
+    size_t lanes_in_batch = std::min(kLanes, num_playouts - playouts_started);
+    LoadPosition(board, lanes_in_batch == kLanes ? ~0ULL : (1ULL << lanes_in_batch) - 1);
+
+    // Retiring before the first move handles starting positions that are already complete.
+    RetireFinishedLanes(starting_player, counts);
+    while (active_lanes_ != 0) {
+      PlayRandomMoves();
+      RetireFinishedLanes(starting_player, counts);
+    }
+  }
+  return counts;
+}
+
+PlayoutCounts BatchPlayout::Play(const SuperBoard& board, size_t num_playouts) {
+  return Play(BitBoard(board), num_playouts);
+}
+
+void BatchPlayout::LoadPosition(const BitBoard& board, uint64_t active_lanes) {
+  const Player kPlayers[] = {Player::kPlayer1, Player::kPlayer2};
+  for (size_t player = 0; player < 2; player++) {
+    for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+      uint16_t marks = board.GetMarks(kPlayers[player], sub_board);
+      for (size_t cell = 0; cell < kNumCells; cell++) {
+        marks_[player][sub_board][cell] = ((marks >> cell) & 1) ? active_lanes : 0;
+      }
+      won_sub_boards_[player][sub_board] =
+          ((board.GetWonSubBoards(kPlayers[player]) >> sub_board) & 1) ? active_lanes : 0;
+    }
+  }
+
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    complete_sub_boards_[sub_board] = ((board.GetCompleteSubBoards() >> sub_board) & 1) ? active_lanes : 0;
+    required_sub_board_[sub_board] = (board.GetRequiredSubBoard() == sub_board ? active_lanes : 0);
+  }
+  active_lanes_ = active_lanes;
+  current_player_ = (board.GetCurrentPlayer() == Player::kPlayer1 ? 0 : 1);
+}
+
+void BatchPlayout::PlayRandomMoves() {
+  uint64_t free_lanes = active_lanes_;
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    free_lanes &= ~required_sub_board_[sub_board];
+  }
+
+  uint64_t candidate_moves[kNumCells][kNumCells];
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    uint64_t playable_lanes = (required_sub_board_[sub_board] | free_lanes) & ~complete_sub_boards_[sub_board];
+    for (size_t cell = 0; cell < kNumCells; cell++) {
+      candidate_moves[sub_board][cell] =
+          playable_lanes & ~(marks_[0][sub_board][cell] | marks_[1][sub_board][cell]);
+    }
+  }
+
+  // Choose one candidate per lane. Lanes with a required sub-board have all of
+  // their candidates in one sub-board, so for those lanes it is enough to choose
+  // among 9 cells, which is done bit-sliced. Lanes that may play anywhere are
+  // comparatively rare (about 1 in 7 moves), and each one instead draws random moves
+  // among all 81 until it draws one of its candidates.
+  uint64_t forced_cells[kNumCells] = {};
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    for (size_t cell = 0; cell < kNumCells; cell++) {
+      forced_cells[cell] |= candidate_moves[sub_board][cell] & ~free_lanes;
+    }
+  }
+  ReduceToSingleRandomCandidate(forced_cells, kNumCells, random_);
+
+  uint64_t free_moves[kNumCells][kNumCells] = {};
+  for (uint64_t lanes = free_lanes; lanes != 0; lanes &= lanes - 1) {
+    uint64_t lane = lanes & (~lanes + 1);
+    while (true) {
+      size_t move = random_.NextBelow(kNumCells * kNumCells);
+      if (candidate_moves[move / kNumCells][move % kNumCells] & lane) {
+        free_moves[move / kNumCells][move % kNumCells] |= lane;
+        break;
+      }
+    }
+  }
+
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    for (size_t cell = 0; cell < kNumCells; cell++) {
+      candidate_moves[sub_board][cell] = (candidate_moves[sub_board][cell] & forced_cells[cell]) |
+                                         free_moves[sub_board][cell];
+    }
+  }
+
+  // Apply the remaining candidate of each lane, updating sub-board completion only for the mover.
+  uint64_t sent_to_sub_board[kNumCells] = {};
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    uint64_t moved_lanes = 0;
+    for (size_t cell = 0; cell < kNumCells; cell++) {
+      marks_[current_player_][sub_board][cell] |= candidate_moves[sub_board][cell];
+      moved_lanes |= candidate_moves[sub_board][cell];
+      sent_to_sub_board[cell] |= candidate_moves[sub_board][cell];
+    }
+    if (moved_lanes == 0) {
+      continue;
+    }
+
+    won_sub_boards_[current_player_][sub_board] |= LanesWithLine(marks_[current_player_][sub_board]) & moved_lanes;
+    uint64_t full_lanes = moved_lanes;
+    for (size_t cell = 0; cell < kNumCells; cell++) {
+      full_lanes &= marks_[0][sub_board][cell] | marks_[1][sub_board][cell];
+    }
+    complete_sub_boards_[sub_board] |= won_sub_boards_[current_player_][sub_board] | full_lanes;
+  }
+
+  // Same rule as SuperBoard: the cell played on determines the next sub-board,
+  // unless that sub-board is complete.
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    required_sub_board_[sub_board] = sent_to_sub_board[sub_board] & ~complete_sub_boards_[sub_board];
+  }
+  current_player_ = 1 - current_player_;
+}
+
+void BatchPlayout::RetireFinishedLanes(size_t starting_player, PlayoutCounts& counts) {
+  uint64_t wins[2];
+  for (size_t player = 0; player < 2; player++) {
+    wins[player] = LanesWithLine(won_sub_boards_[player]) & active_lanes_;
+  }
+  uint64_t all_complete_lanes = active_lanes_;
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    all_complete_lanes &= complete_sub_boards_[sub_board];
+  }
+  uint64_t tied_lanes = all_complete_lanes & ~wins[0] & ~wins[1];
+
+  counts.wins += PopCount64(wins[starting_player]);
+  counts.losses += PopCount64(wins[1 - starting_player]);
+  counts.draws += PopCount64(tied_lanes);
+  active_lanes_ &= ~(wins[0] | wins[1] | tied_lanes);
+}
+
+}  // namespace ultimate_tictactoe
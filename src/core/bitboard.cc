@@ -0,0 +1,292 @@
+#include <core/bitboard.h>
+#include <core/subboard.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+// Precomputes IsWinningMask for every 9-bit mask, so that win checks in hot loops
+// are a single lookup.
+struct WinningMaskTable {
+  bool values[BitBoard::kFullMask + 1];
+
+  WinningMaskTable() {
+    for (size_t mask = 0; mask <= BitBoard::kFullMask; mask++) {
+      values[mask] = false;
+      for (uint16_t line : BitBoard::kLineMasks) {
+        if ((mask & line) == line) {
+          values[mask] = true;
+        }
+      }
+    }
+  }
+};
+
+const WinningMaskTable kWinningMaskTable;
+
+// Precomputes BitBoard::GetWinningCells for every pair of 9-bit masks (512 KB), so that
+// threats can be found with a single lookup.
+struct WinningCellTable {
+  uint16_t values[(BitBoard::kFullMask + 1) * (BitBoard::kFullMask + 1)];
+
+  WinningCellTable() {
+    for (size_t marks = 0; marks <= BitBoard::kFullMask; marks++) {
+      for (size_t other_marks = 0; other_marks <= BitBoard::kFullMask; other_marks++) {
+        uint16_t winning_cells = 0;
+        for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+          uint16_t cell_mask = static_cast<uint16_t>(1 << cell);
+          if (!((marks | other_marks) & cell_mask) && kWinningMaskTable.values[marks | cell_mask]) {
+            winning_cells |= cell_mask;
+          }
+        }
+        values[marks * (BitBoard::kFullMask + 1) + other_marks] = winning_cells;
+      }
+    }
+  }
+};
+
+const WinningCellTable kWinningCellTable;
+
+// Random keys for BitBoard's Zobrist hash. They are generated with a fixed seed, so that
+// hashes are the same on every run.
+struct ZobristKeyTable {
+  uint64_t values[2 * BitBoard::kNumCells * BitBoard::kNumCells + BitBoard::kNumCells + 2];
+
+  ZobristKeyTable() {
+    // SplitMix64
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for (uint64_t& value : values) {
+      state += 0x9E3779B97F4A7C15ULL;
+      uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      value = z ^ (z >> 31);
+    }
+  }
+};
+
+const ZobristKeyTable kZobristKeyTable;
+
+// kSymmetryIndices[symmetry][index] is the index that the symmetry moves a row-major index
+// of a 3x3 grid to. In order: identity, rotations by 90, 180, and 270 degrees clockwise,
+// and reflections across the vertical axis, the horizontal axis, the main diagonal, and the
+// anti-diagonal.
+const size_t kSymmetryIndices[BitBoard::kNumSymmetries][BitBoard::kNumCells] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8},
+    {2, 5, 8, 1, 4, 7, 0, 3, 6},
+    {8, 7, 6, 5, 4, 3, 2, 1, 0},
+    {6, 3, 0, 7, 4, 1, 8, 5, 2},
+    {2, 1, 0, 5, 4, 3, 8, 7, 6},
+    {6, 7, 8, 3, 4, 5, 0, 1, 2},
+    {0, 3, 6, 1, 4, 7, 2, 5, 8},
+    {8, 5, 2, 7, 4, 1, 6, 3, 0}};
+
+// The rotations by 90 and 270 degrees undo each other; every other symmetry undoes itself.
+const size_t kInverseSymmetries[BitBoard::kNumSymmetries] = {0, 3, 2, 1, 4, 5, 6, 7};
+
+// Precomputes the transformation of every 9-bit mask by every symmetry, so that checking
+// whether a position is symmetric takes a lookup per sub-board.
+struct TransformedMaskTable {
+  uint16_t values[BitBoard::kNumSymmetries][BitBoard::kFullMask + 1];
+
+  TransformedMaskTable() {
+    for (size_t symmetry = 0; symmetry < BitBoard::kNumSymmetries; symmetry++) {
+      for (size_t mask = 0; mask <= BitBoard::kFullMask; mask++) {
+        values[symmetry][mask] = 0;
+        for (size_t index = 0; index < BitBoard::kNumCells; index++) {
+          if (mask & (1 << index)) {
+            values[symmetry][mask] |= static_cast<uint16_t>(1 << kSymmetryIndices[symmetry][index]);
+          }
+        }
+      }
+    }
+  }
+};
+
+const TransformedMaskTable kTransformedMaskTable;
+
+}  // namespace
+
+constexpr size_t BitBoard::kBoardSize;
+constexpr size_t BitBoard::kNumCells;
+constexpr uint16_t BitBoard::kFullMask;
+constexpr size_t BitBoard::kNoRequiredSubBoard;
+constexpr size_t BitBoard::kNumSymmetries;
+constexpr size_t BitBoard::kNumLines;
+constexpr uint16_t BitBoard::kLineMasks[];
+constexpr size_t BitBoard::kZobristRequiredSubBoardOffset;
+constexpr size_t BitBoard::kZobristPlayer2Offset;
+
+const bool* const BitBoard::winning_masks_ = kWinningMaskTable.values;
+const uint16_t* const BitBoard::winning_cells_ = kWinningCellTable.values;
+const uint64_t* const BitBoard::zobrist_keys_ = kZobristKeyTable.values;
+
+BitBoard::BitBoard() : won_sub_boards_{0, 0}, complete_sub_boards_(0),
+                       required_sub_board_(kNoRequiredSubBoard), current_player_(0),
+                       hash_(zobrist_keys_[kZobristRequiredSubBoardOffset + kNoRequiredSubBoard]) {
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    marks_[0][sub_board] = 0;
+    marks_[1][sub_board] = 0;
+  }
+}
+
+BitBoard::BitBoard(const SuperBoard& board) : BitBoard() {
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    const SubBoard& grid = board.GetState()[sub_board / kBoardSize][sub_board % kBoardSize];
+    for (size_t cell = 0; cell < kNumCells; cell++) {
+      Mark::MarkData mark = grid.GetState()[cell / kBoardSize][cell % kBoardSize].GetState();
+      if (mark == Mark::MarkData::kPlayer1) {
+        marks_[0][sub_board] |= static_cast<uint16_t>(1 << cell);
+      } else if (mark == Mark::MarkData::kPlayer2) {
+        marks_[1][sub_board] |= static_cast<uint16_t>(1 << cell);
+      }
+    }
+
+    WinState sub_board_winner = grid.GetWinner();
+    if (sub_board_winner == WinState::kPlayer1Win) {
+      won_sub_boards_[0] |= static_cast<uint16_t>(1 << sub_board);
+    } else if (sub_board_winner == WinState::kPlayer2Win) {
+      won_sub_boards_[1] |= static_cast<uint16_t>(1 << sub_board);
+    }
+    if (sub_board_winner != WinState::kInProgress) {
+      complete_sub_boards_ |= static_cast<uint16_t>(1 << sub_board);
+    }
+  }
+
+  if (board.NextRequiredSubBoardExists()) {
+    required_sub_board_ = static_cast<uint8_t>(board.GetNextRequiredSubBoard().x * kBoardSize +
+                                               board.GetNextRequiredSubBoard().y);
+  }
+  current_player_ = (board.GetCurrentPlayer() == Player::kPlayer1 ? 0 : 1);
+  hash_ = ComputeHash();
+}
+
+BitBoard BitBoard::GetTransformed(size_t symmetry) const {
+  BitBoard transformed;
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    size_t transformed_sub_board = TransformIndex(symmetry, sub_board);
+    transformed.marks_[0][transformed_sub_board] = TransformMask(symmetry, marks_[0][sub_board]);
+    transformed.marks_[1][transformed_sub_board] = TransformMask(symmetry, marks_[1][sub_board]);
+  }
+  transformed.won_sub_boards_[0] = TransformMask(symmetry, won_sub_boards_[0]);
+  transformed.won_sub_boards_[1] = TransformMask(symmetry, won_sub_boards_[1]);
+  transformed.complete_sub_boards_ = TransformMask(symmetry, complete_sub_boards_);
+  if (required_sub_board_ != kNoRequiredSubBoard) {
+    transformed.required_sub_board_ = static_cast<uint8_t>(TransformIndex(symmetry, required_sub_board_));
+  }
+  transformed.current_player_ = current_player_;
+  transformed.hash_ = transformed.ComputeHash();
+  return transformed;
+}
+
+size_t BitBoard::GetCanonicalSymmetry() const {
+  size_t canonical_symmetry = 0;
+  uint64_t canonical_hash = hash_;
+  for (size_t symmetry = 1; symmetry < kNumSymmetries; symmetry++) {
+    uint64_t transformed_hash = GetTransformed(symmetry).GetHash();
+    if (transformed_hash < canonical_hash) {
+      canonical_hash = transformed_hash;
+      canonical_symmetry = symmetry;
+    }
+  }
+  return canonical_symmetry;
+}
+
+uint8_t BitBoard::GetStabilizerSymmetries() const {
+  uint8_t symmetries = 1;
+  for (size_t symmetry = 1; symmetry < kNumSymmetries; symmetry++) {
+    if (required_sub_board_ != kNoRequiredSubBoard &&
+        TransformIndex(symmetry, required_sub_board_) != required_sub_board_) {
+      continue;
+    }
+    // The marks decide the rest of the position, so only they need to be compared.
+    bool is_stabilizer = true;
+    for (size_t sub_board = 0; sub_board < kNumCells && is_stabilizer; sub_board++) {
+      size_t transformed_sub_board = TransformIndex(symmetry, sub_board);
+      is_stabilizer = marks_[0][transformed_sub_board] == TransformMask(symmetry, marks_[0][sub_board]) &&
+                      marks_[1][transformed_sub_board] == TransformMask(symmetry, marks_[1][sub_board]);
+    }
+    if (is_stabilizer) {
+      symmetries |= static_cast<uint8_t>(1 << symmetry);
+    }
+  }
+  return symmetries;
+}
+
+uint64_t BitBoard::GetCanonicalHash() const {
+  return GetTransformed(GetCanonicalSymmetry()).GetHash();
+}
+
+size_t BitBoard::CountValidMoves() const {
+  size_t count = 0;
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    count += PopCount(GetValidCellMask(sub_board));
+  }
+  return count;
+}
+
+Action BitBoard::GetNthValidMove(size_t n) const {
+  size_t sub_board = 0;
+  while (n >= PopCount(GetValidCellMask(sub_board))) {
+    n -= PopCount(GetValidCellMask(sub_board));
+    sub_board++;
+  }
+  return ToAction(sub_board, SelectNthSetBit(GetValidCellMask(sub_board), n));
+}
+
+size_t BitBoard::CountOpenCells() const {
+  size_t count = 0;
+  for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+    if (!(complete_sub_boards_ & (1 << sub_board))) {
+      count += PopCount(~(marks_[0][sub_board] | marks_[1][sub_board]) & kFullMask);
+    }
+  }
+  return count;
+}
+
+Action BitBoard::ToAction(size_t sub_board, size_t cell) {
+  return {sub_board / kBoardSize, sub_board % kBoardSize, cell / kBoardSize, cell % kBoardSize};
+}
+
+size_t BitBoard::SubBoardIndex(const Action& a) {
+  return a.row_in_board * kBoardSize + a.col_in_board;
+}
+
+size_t BitBoard::CellIndex(const Action& a) {
+  return a.row_in_subboard * kBoardSize + a.col_in_subboard;
+}
+
+size_t BitBoard::TransformIndex(size_t symmetry, size_t index) {
+  return kSymmetryIndices[symmetry][index];
+}
+
+size_t BitBoard::InverseSymmetry(size_t symmetry) {
+  return kInverseSymmetries[symmetry];
+}
+
+Action BitBoard::TransformAction(size_t symmetry, const Action& a) {
+  return ToAction(TransformIndex(symmetry, SubBoardIndex(a)), TransformIndex(symmetry, CellIndex(a)));
+}
+
+uint64_t BitBoard::ComputeHash() const {
+  uint64_t hash = zobrist_keys_[kZobristRequiredSubBoardOffset + required_sub_board_];
+  for (size_t player = 0; player < 2; player++) {
+    for (size_t sub_board = 0; sub_board < kNumCells; sub_board++) {
+      for (size_t cell = 0; cell < kNumCells; cell++) {
+        if (marks_[player][sub_board] & (1 << cell)) {
+          hash ^= zobrist_keys_[(player * kNumCells + sub_board) * kNumCells + cell];
+        }
+      }
+    }
+  }
+  if (current_player_ == 1) {
+    hash ^= zobrist_keys_[kZobristPlayer2Offset];
+  }
+  return hash;
+}
+
+uint16_t BitBoard::TransformMask(size_t symmetry, uint16_t mask) {
+  return kTransformedMaskTable.values[symmetry][mask & kFullMask];
+}
+
+}  // namespace ultimate_tictactoe
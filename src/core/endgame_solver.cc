@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <core/endgame_solver.h>
+
+namespace ultimate_tictactoe {
+
+constexpr size_t EndgameSolver::kDefaultTableSizeLog2;
+constexpr size_t EndgameSolver::kDefaultMaxNodes;
+constexpr int EndgameSolver::kWinScore;
+constexpr int EndgameSolver::kMaxPly;
+
+EndgameSolver::EndgameSolver(size_t table_size_log2, size_t max_nodes)
+    : table_size_log2_(table_size_log2), max_nodes_(max_nodes), generation_(1), nodes_searched_(0),
+      out_of_nodes_(false), root_best_move_(0) {}
+
+bool EndgameSolver::Solve(const BitBoard& board, EndgameSolution& solution) {
+  if (board.IsComplete()) {
+    throw std::runtime_error("The game is complete, so there is nothing to solve.");
+  }
+  if (table_.empty()) {
+    table_.resize(static_cast<size_t>(1) << table_size_log2_, TableEntry{0, 0, 0, Bound::kExact, 0});
+  }
+
+  nodes_searched_ = 0;
+  out_of_nodes_ = false;
+  int score = Search(board, -kWinScore, kWinScore, 0);
+  if (out_of_nodes_) {
+    return false;
+  }
+
+  if (score > 0) {
+    solution.outcome = 1;
+    solution.distance_to_end = static_cast<size_t>(kWinScore - score);
+  } else if (score < 0) {
+    solution.outcome = -1;
+    solution.distance_to_end = static_cast<size_t>(kWinScore + score);
+  } else {
+    solution.outcome = 0;
+    solution.distance_to_end = 0;
+  }
+  solution.best_move = BitBoard::ToAction(root_best_move_ / BitBoard::kNumCells, root_best_move_ % BitBoard::kNumCells);
+  return true;
+}
+
+size_t EndgameSolver::GetNodesSearched() const {
+  return nodes_searched_;
+}
+
+void EndgameSolver::Clear() {
+  // Entries from older generations are ignored, so the table does not need to be wiped.
+  generation_++;
+}
+
+int EndgameSolver::Search(const BitBoard& board, int alpha, int beta, size_t ply) {
+  if (++nodes_searched_ > max_nodes_) {
+    out_of_nodes_ = true;
+    return 0;
+  }
+
+  WinState winner = board.GetWinner();
+  if (winner == WinState::kTie) {
+    return 0;
+  } else if (winner != WinState::kInProgress) {
+    // The player who just moved won.
+    return -(kWinScore - static_cast<int>(ply));
+  } else if (ply > 0 && board.IsDeadDraw()) {
+    // The game can only end in a tie. Dead draws at the root are still searched, so that
+    // there is a best move to return.
+    return 0;
+  }
+
+  // Mate distance pruning: the game is not over, so the best possible result is winning with
+  // the next move, and the worst is losing after the opponent's reply.
+  alpha = std::max(alpha, -(kWinScore - static_cast<int>(ply) - 2));
+  beta = std::min(beta, kWinScore - static_cast<int>(ply) - 1);
+  if (alpha >= beta) {
+    return alpha;
+  }
+
+  // A move that wins the game right away is the best possible, so no other move is searched.
+  size_t winning_sub_board;
+  size_t winning_cell;
+  if (board.FindWinningMove(winning_sub_board, winning_cell)) {
+    int score = kWinScore - static_cast<int>(ply) - 1;
+    return Store(board, score, Bound::kExact, EncodeMove(winning_sub_board, winning_cell), ply);
+  }
+
+  uint8_t table_move = BitBoard::kNumCells * BitBoard::kNumCells;
+  const TableEntry& entry = table_[board.GetHash() & (table_.size() - 1)];
+  if (entry.generation == generation_ && entry.hash == board.GetHash()) {
+    // Convert the score from relative to the entry's position back to relative to the root.
+    int score = entry.score;
+    if (score > kWinScore - kMaxPly) {
+      score -= static_cast<int>(ply);
+    } else if (score < -(kWinScore - kMaxPly)) {
+      score += static_cast<int>(ply);
+    }
+    if (entry.bound == Bound::kExact || (entry.bound == Bound::kLower && score >= beta) ||
+        (entry.bound == Bound::kUpper && score <= alpha)) {
+      if (ply == 0) {
+        root_best_move_ = entry.best_move;
+      }
+      return score;
+    }
+    table_move = entry.best_move;
+  }
+
+  uint8_t moves[BitBoard::kNumCells * BitBoard::kNumCells];
+  size_t num_moves = 0;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    uint16_t valid_cells = board.GetValidCellMask(sub_board);
+    for (; valid_cells != 0; valid_cells &= valid_cells - 1) {
+      moves[num_moves++] = EncodeMove(sub_board, SelectNthSetBit(valid_cells, 0));
+    }
+  }
+
+  // The move that was best the last time the position was searched is searched first.
+  uint8_t* table_move_position = std::find(moves, moves + num_moves, table_move);
+  if (table_move_position != moves + num_moves) {
+    std::rotate(moves, table_move_position, table_move_position + 1);
+  }
+
+  int original_alpha = alpha;
+  int best_score = -kWinScore;
+  uint8_t best_move = moves[0];
+  for (size_t i = 0; i < num_moves; i++) {
+    BitBoard child = board;
+    child.PlayMove(moves[i] / BitBoard::kNumCells, moves[i] % BitBoard::kNumCells);
+    int score = -Search(child, -beta, -alpha, ply + 1);
+    if (out_of_nodes_) {
+      return 0;
+    }
+    if (score > best_score) {
+      best_score = score;
+      best_move = moves[i];
+    }
+    alpha = std::max(alpha, score);
+    if (alpha >= beta) {
+      break;
+    }
+  }
+
+  Bound bound = Bound::kExact;
+  if (best_score <= original_alpha) {
+    bound = Bound::kUpper;
+  } else if (best_score >= beta) {
+    bound = Bound::kLower;
+  }
+  return Store(board, best_score, bound, best_move, ply);
+}
+
+int EndgameSolver::Store(const BitBoard& board, int score, Bound bound, uint8_t best_move, size_t ply) {
+  if (ply == 0) {
+    root_best_move_ = best_move;
+  }
+
+  int stored_score = score;
+  if (score > kWinScore - kMaxPly) {
+    stored_score += static_cast<int>(ply);
+  } else if (score < -(kWinScore - kMaxPly)) {
+    stored_score -= static_cast<int>(ply);
+  }
+  table_[board.GetHash() & (table_.size() - 1)] = {board.GetHash(), generation_, static_cast<int16_t>(stored_score),
+                                                  bound, best_move};
+  return score;
+}
+
+uint8_t EndgameSolver::EncodeMove(size_t sub_board, size_t cell) {
+  return static_cast<uint8_t>(sub_board * BitBoard::kNumCells + cell);
+}
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,20 @@
+#include <stdexcept>
+
+#include <core/evaluation_cache.h>
+
+namespace ultimate_tictactoe {
+
+constexpr size_t EvaluationCache::kDefaultSizeLog2;
+constexpr size_t EvaluationCache::kMaxSizeLog2;
+
+EvaluationCache::EvaluationCache(size_t size_log2) : size_log2_(size_log2), generation_(1) {
+  if (size_log2 > kMaxSizeLog2) {
+    throw std::invalid_argument("The evaluation cache can have at most 2^EvaluationCache::kMaxSizeLog2 entries.");
+  }
+}
+
+void EvaluationCache::Clear() {
+  generation_++;
+}
+
+}  // namespace ultimate_tictactoe
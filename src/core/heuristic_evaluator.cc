@@ -0,0 +1,66 @@
+#include <algorithm>
+
+#include <core/heuristic_evaluator.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+// Precomputes, for every pair of a player's marks and the opponent's marks in a sub-board,
+// the index in kWinChanceMetrics of the player's win chance metric in the sub-board: 0 if
+// every line has one of the opponent's marks, and otherwise 1 plus the largest number of
+// the player's marks along a line without the opponent's marks.
+struct WinChanceMetricTable {
+  uint8_t indices[(BitBoard::kFullMask + 1) * (BitBoard::kFullMask + 1)];
+
+  WinChanceMetricTable() {
+    for (size_t marks = 0; marks <= BitBoard::kFullMask; marks++) {
+      for (size_t opponent_marks = 0; opponent_marks <= BitBoard::kFullMask; opponent_marks++) {
+        uint8_t index = 0;
+        for (uint16_t line : BitBoard::kLineMasks) {
+          if ((line & opponent_marks) == 0) {
+            index = std::max(index, static_cast<uint8_t>(1 + PopCount(line & marks)));
+          }
+        }
+        indices[marks * (BitBoard::kFullMask + 1) + opponent_marks] = index;
+      }
+    }
+  }
+};
+
+const WinChanceMetricTable kWinChanceMetricTable;
+
+// Precomputes, for every mask of sub-boards won by the opponent, the number of lines through
+// each sub-board that contain none of them (the possible win line counts of
+// TreeSearchAI::ComputePossibleWinLineCounts).
+struct PossibleWinLineCountTable {
+  double counts[BitBoard::kFullMask + 1][BitBoard::kNumCells];
+
+  PossibleWinLineCountTable() {
+    for (size_t opponent_won_sub_boards = 0; opponent_won_sub_boards <= BitBoard::kFullMask;
+         opponent_won_sub_boards++) {
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        counts[opponent_won_sub_boards][sub_board] = 0;
+        for (uint16_t line : BitBoard::kLineMasks) {
+          if ((line & opponent_won_sub_boards) == 0 && (line & (1 << sub_board))) {
+            counts[opponent_won_sub_boards][sub_board]++;
+          }
+        }
+      }
+    }
+  }
+};
+
+const PossibleWinLineCountTable kPossibleWinLineCountTable;
+
+}  // namespace
+
+constexpr double HeuristicEvaluator::kRescalingFactor;
+constexpr bool HeuristicEvaluator::kPrefersBatches;
+constexpr bool HeuristicEvaluator::kIsSymmetric;
+constexpr double HeuristicEvaluator::kWinChanceMetrics[];
+
+const uint8_t* const HeuristicEvaluator::win_chance_metric_indices_ = kWinChanceMetricTable.indices;
+const double* const HeuristicEvaluator::possible_win_line_counts_ = kPossibleWinLineCountTable.counts[0];
+
+}  // namespace ultimate_tictactoe
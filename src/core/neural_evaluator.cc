@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include <core/neural_evaluator.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+constexpr size_t kAccumulatorSize = NeuralNetworkWeights::kAccumulatorSize;
+constexpr size_t kHiddenSize = NeuralNetworkWeights::kHiddenSize;
+constexpr size_t kHeaderSize = 12;
+
+static_assert(kAccumulatorSize % 32 == 0 && kHiddenSize % 32 == 0,
+              "The layer sizes must be multiples of the widest vector used by the layers.");
+
+// Adds the weights of a feature to an accumulator.
+void AddFeature(int16_t* accumulator, const int16_t* feature_weights) {
+#if defined(__AVX2__)
+  for (size_t i = 0; i < kAccumulatorSize; i += 16) {
+    __m256i* values = reinterpret_cast<__m256i*>(accumulator + i);
+    __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(feature_weights + i));
+    _mm256_storeu_si256(values, _mm256_add_epi16(_mm256_loadu_si256(values), weights));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (size_t i = 0; i < kAccumulatorSize; i += 8) {
+    __m128i* values = reinterpret_cast<__m128i*>(accumulator + i);
+    __m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i*>(feature_weights + i));
+    _mm_storeu_si128(values, _mm_add_epi16(_mm_loadu_si128(values), weights));
+  }
+#else
+  for (size_t i = 0; i < kAccumulatorSize; i++) {
+    accumulator[i] = static_cast<int16_t>(accumulator[i] + feature_weights[i]);
+  }
+#endif
+}
+
+// Returns the dot product of size values, clipped to [0, kActivationMax] so that the pairwise
+// sums of maddubs cannot saturate, with int8 weights. size must be a multiple of 32.
+int32_t DotProduct(const uint8_t* values, const int8_t* weights, size_t size) {
+#if defined(__AVX2__)
+  __m256i sums = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+  for (size_t i = 0; i < size; i += 32) {
+    __m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+    sums = _mm256_add_epi32(sums, _mm256_madd_epi16(products, ones));
+  }
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+#elif defined(__SSSE3__)
+  __m128i sums = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  for (size_t i = 0; i < size; i += 16) {
+    __m128i products = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i)));
+    sums = _mm_add_epi32(sums, _mm_madd_epi16(products, ones));
+  }
+  sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+  sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sums);
+#else
+  int32_t sum = 0;
+  for (size_t i = 0; i < size; i++) {
+    sum += static_cast<int32_t>(values[i]) * weights[i];
+  }
+  return sum;
+#endif
+}
+
+uint8_t ClipActivation(int32_t value) {
+  return static_cast<uint8_t>(std::min(std::max(value, 0), NeuralEvaluator::kActivationMax));
+}
+
+// Runs a dense layer with kHiddenSize outputs, clipping the outputs for the next layer.
+void DenseLayer(const uint8_t* inputs, size_t num_inputs, const int8_t* weights, const int32_t* biases,
+                uint8_t* outputs) {
+  for (size_t i = 0; i < kHiddenSize; i++) {
+    int32_t sum = biases[i] + DotProduct(inputs, weights + i * num_inputs, num_inputs);
+    outputs[i] = ClipActivation(sum >> NeuralEvaluator::kWeightShift);
+  }
+}
+
+size_t FeatureIndex(size_t sub_board, size_t cell, bool opponent_mark) {
+  return (sub_board * BitBoard::kNumCells + cell) * 2 + (opponent_mark ? 1 : 0);
+}
+
+}  // namespace
+
+constexpr char NeuralEvaluator::kMagic[9];
+constexpr uint32_t NeuralEvaluator::kVersion;
+constexpr int32_t NeuralEvaluator::kActivationMax;
+constexpr int NeuralEvaluator::kWeightShift;
+constexpr double NeuralEvaluator::kOutputScale;
+constexpr bool NeuralEvaluator::kPrefersBatches;
+constexpr bool NeuralEvaluator::kIsSymmetric;
+
+NeuralEvaluator::NeuralEvaluator() : weights_(new NeuralNetworkWeights()) {}
+
+void NeuralEvaluator::Load(const string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not open the neural network weight file " + path + ".");
+  }
+  char header[kHeaderSize];
+  uint32_t version = 0;
+  std::unique_ptr<NeuralNetworkWeights> weights(new NeuralNetworkWeights());
+  file.read(header, kHeaderSize);
+  std::memcpy(&version, header + 8, sizeof(version));
+  file.read(reinterpret_cast<char*>(weights.get()), sizeof(NeuralNetworkWeights));
+  if (!file || file.peek() != std::ifstream::traits_type::eof() || std::memcmp(header, kMagic, 8) != 0 ||
+      version != kVersion) {
+    throw std::runtime_error("The file " + path + " is not a valid neural network weight file.");
+  }
+  weights_ = std::move(weights);
+  accumulators_.clear();
+}
+
+void NeuralEvaluator::Write(const string& path, const NeuralNetworkWeights& weights) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  uint32_t version = kVersion;
+  file.write(kMagic, 8);
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(&weights), sizeof(NeuralNetworkWeights));
+  if (!file) {
+    throw std::runtime_error("Could not write the neural network weight file " + path + ".");
+  }
+}
+
+void NeuralEvaluator::SetWeights(const NeuralNetworkWeights& weights) {
+  *weights_ = weights;
+  accumulators_.clear();
+}
+
+const NeuralNetworkWeights& NeuralEvaluator::GetWeights() const {
+  return *weights_;
+}
+
+double NeuralEvaluator::Evaluate(const BitBoard& board) const {
+  if (accumulators_.empty()) {
+    Accumulator accumulator;
+    ComputeAccumulator(board, accumulator);
+    return EvaluateAccumulator(accumulator, board.GetCurrentPlayer());
+  }
+  return EvaluateAccumulator(accumulators_.back(), board.GetCurrentPlayer());
+}
+
+void NeuralEvaluator::Reset(const BitBoard& board) {
+  accumulators_.resize(1);
+  ComputeAccumulator(board, accumulators_[0]);
+}
+
+void NeuralEvaluator::PlayMove(Player player, size_t sub_board, size_t cell) {
+  if (accumulators_.empty()) {
+    return;
+  }
+  accumulators_.push_back(accumulators_.back());
+  Accumulator& accumulator = accumulators_.back();
+  for (size_t perspective = 0; perspective < 2; perspective++) {
+    bool opponent_mark = (static_cast<size_t>(player) != perspective);
+    AddFeature(accumulator.values[perspective],
+               weights_->feature_weights[FeatureIndex(sub_board, cell, opponent_mark)]);
+  }
+}
+
+void NeuralEvaluator::ReverseMove() {
+  if (!accumulators_.empty()) {
+    accumulators_.pop_back();
+  }
+}
+
+void NeuralEvaluator::EvaluateBatch(const PositionBatch& batch, double* values) const {
+  Accumulator accumulator;
+  for (size_t i = 0; i < batch.size; i++) {
+    size_t player_to_move = static_cast<size_t>(batch.players_to_move[i]);
+    if (accumulators_.empty()) {
+      uint16_t marks[2][BitBoard::kNumCells];
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        marks[player_to_move][sub_board] = batch.marks[0][sub_board][i];
+        marks[1 - player_to_move][sub_board] = batch.marks[1][sub_board][i];
+      }
+      ComputeAccumulator(marks, accumulator);
+    } else {
+      // The same update as PlayMove, for the player who moved into the position.
+      accumulator = accumulators_.back();
+      for (size_t perspective = 0; perspective < 2; perspective++) {
+        bool opponent_mark = (perspective == player_to_move);
+        AddFeature(accumulator.values[perspective],
+                   weights_->feature_weights[FeatureIndex(batch.move_sub_boards[i], batch.move_cells[i],
+                                                          opponent_mark)]);
+      }
+    }
+    values[i] = EvaluateAccumulator(accumulator, batch.players_to_move[i]);
+  }
+}
+
+void NeuralEvaluator::ComputeAccumulator(const BitBoard& board, Accumulator& accumulator) const {
+  uint16_t marks[2][BitBoard::kNumCells];
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    for (size_t player = 0; player < 2; player++) {
+      marks[player][sub_board] = board.GetMarks(static_cast<Player>(player), sub_board);
+    }
+  }
+  ComputeAccumulator(marks, accumulator);
+}
+
+void NeuralEvaluator::ComputeAccumulator(const uint16_t marks[2][BitBoard::kNumCells],
+                                         Accumulator& accumulator) const {
+  for (size_t perspective = 0; perspective < 2; perspective++) {
+    std::memcpy(accumulator.values[perspective], weights_->feature_biases, sizeof(weights_->feature_biases));
+    for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+      for (size_t player = 0; player < 2; player++) {
+        for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+          if (marks[player][sub_board] & (1 << cell)) {
+            AddFeature(accumulator.values[perspective],
+                       weights_->feature_weights[FeatureIndex(sub_board, cell, player != perspective)]);
+          }
+        }
+      }
+    }
+  }
+}
+
+double NeuralEvaluator::EvaluateAccumulator(const Accumulator& accumulator, Player player) const {
+  uint8_t inputs[2 * kAccumulatorSize];
+  size_t player_index = static_cast<size_t>(player);
+  for (size_t i = 0; i < kAccumulatorSize; i++) {
+    inputs[i] = ClipActivation(accumulator.values[player_index][i]);
+    inputs[kAccumulatorSize + i] = ClipActivation(accumulator.values[1 - player_index][i]);
+  }
+
+  uint8_t hidden1[kHiddenSize];
+  uint8_t hidden2[kHiddenSize];
+  DenseLayer(inputs, 2 * kAccumulatorSize, &weights_->hidden1_weights[0][0], weights_->hidden1_biases, hidden1);
+  DenseLayer(hidden1, kHiddenSize, &weights_->hidden2_weights[0][0], weights_->hidden2_biases, hidden2);
+  int32_t output = weights_->output_bias + DotProduct(hidden2, weights_->output_weights, kHiddenSize);
+  return tanh(output / kOutputScale);
+}
+
+}  // namespace ultimate_tictactoe
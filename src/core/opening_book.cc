@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <core/bitboard.h>
+#include <core/opening_book.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPENING_BOOK_USES_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+static_assert(sizeof(OpeningBookEntry) == 16, "Opening book entries must be 16 bytes, as in the file format.");
+
+const size_t kHeaderSize = 16;
+
+// Checks the header at the start of a book file of the given size, and returns the number
+// of entries. Throws a runtime_error exception if the header is invalid.
+size_t ReadHeader(const char* header, size_t file_size, const string& path) {
+  uint32_t version;
+  uint32_t num_entries;
+  std::memcpy(&version, header + 8, sizeof(version));
+  std::memcpy(&num_entries, header + 12, sizeof(num_entries));
+  if (file_size < kHeaderSize || std::memcmp(header, OpeningBook::kMagic, 8) != 0 ||
+      version != OpeningBook::kVersion || file_size != kHeaderSize + num_entries * sizeof(OpeningBookEntry)) {
+    throw std::runtime_error("The file " + path + " is not a valid opening book.");
+  }
+  return num_entries;
+}
+
+}  // namespace
+
+constexpr char OpeningBook::kMagic[9];
+constexpr uint32_t OpeningBook::kVersion;
+constexpr double OpeningBook::kValueScale;
+
+OpeningBook::OpeningBook()
+    : is_open_(false), entries_(nullptr), num_entries_(0), mapped_data_(nullptr), mapped_size_(0) {}
+
+OpeningBook::~OpeningBook() {
+  Close();
+}
+
+void OpeningBook::Open(const string& path) {
+  Close();
+
+#ifdef OPENING_BOOK_USES_MMAP
+  int file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error("Could not open the opening book file " + path + ".");
+  }
+  struct stat file_stat;
+  if (fstat(file, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < kHeaderSize) {
+    close(file);
+    throw std::runtime_error("The file " + path + " is not a valid opening book.");
+  }
+  size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void* data = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file, 0);
+  // The mapping stays valid after the file is closed.
+  close(file);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Could not map the opening book file " + path + ".");
+  }
+  mapped_data_ = data;
+  mapped_size_ = file_size;
+
+  try {
+    num_entries_ = ReadHeader(static_cast<const char*>(data), file_size, path);
+  } catch (const std::runtime_error&) {
+    Close();
+    throw;
+  }
+  entries_ = reinterpret_cast<const OpeningBookEntry*>(static_cast<const char*>(data) + kHeaderSize);
+  is_open_ = true;
+#else
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw std::runtime_error("Could not open the opening book file " + path + ".");
+  }
+  size_t file_size = static_cast<size_t>(file.tellg());
+  char header[kHeaderSize] = {};
+  file.seekg(0);
+  file.read(header, kHeaderSize);
+  size_t num_entries = ReadHeader(header, file_size, path);
+
+  read_entries_.resize(num_entries);
+  file.read(reinterpret_cast<char*>(read_entries_.data()), num_entries * sizeof(OpeningBookEntry));
+  if (!file) {
+    read_entries_.clear();
+    throw std::runtime_error("Could not read the opening book file " + path + ".");
+  }
+  num_entries_ = num_entries;
+  entries_ = read_entries_.data();
+  is_open_ = true;
+#endif
+}
+
+void OpeningBook::Close() {
+#ifdef OPENING_BOOK_USES_MMAP
+  if (mapped_data_ != nullptr) {
+    munmap(mapped_data_, mapped_size_);
+  }
+#endif
+  mapped_data_ = nullptr;
+  mapped_size_ = 0;
+  read_entries_.clear();
+  entries_ = nullptr;
+  num_entries_ = 0;
+  is_open_ = false;
+}
+
+bool OpeningBook::IsOpen() const {
+  return is_open_;
+}
+
+size_t OpeningBook::GetNumEntries() const {
+  return num_entries_;
+}
+
+bool OpeningBook::Probe(const SuperBoard& board, size_t min_depth, Action& move) const {
+  if (num_entries_ == 0) {
+    return false;
+  }
+
+  BitBoard bit_board(board);
+  size_t symmetry = bit_board.GetCanonicalSymmetry();
+  uint64_t position_hash = bit_board.GetTransformed(symmetry).GetHash();
+  const OpeningBookEntry* entries_end = entries_ + num_entries_;
+  const OpeningBookEntry* entry = std::lower_bound(entries_, entries_end, position_hash,
+                                                   [](const OpeningBookEntry& e, uint64_t hash) {
+                                                     return e.position_hash < hash;
+                                                   });
+  if (entry == entries_end || entry->position_hash != position_hash || entry->depth < min_depth) {
+    return false;
+  }
+
+  Action canonical_move = BitBoard::ToAction(entry->move / BitBoard::kNumCells, entry->move % BitBoard::kNumCells);
+  Action book_move = BitBoard::TransformAction(BitBoard::InverseSymmetry(symmetry), canonical_move);
+
+  // Guards against hash collisions with positions that are not in the book.
+  if (!board.IsValidMove(book_move)) {
+    return false;
+  }
+  move = book_move;
+  return true;
+}
+
+void OpeningBook::Write(const string& path, vector<OpeningBookEntry> entries) {
+  std::sort(entries.begin(), entries.end(), [](const OpeningBookEntry& e1, const OpeningBookEntry& e2) {
+    return e1.position_hash < e2.position_hash ||
+           (e1.position_hash == e2.position_hash && e1.depth > e2.depth);
+  });
+  entries.erase(std::unique(entries.begin(), entries.end(),
+                            [](const OpeningBookEntry& e1, const OpeningBookEntry& e2) {
+                              return e1.position_hash == e2.position_hash;
+                            }),
+                entries.end());
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  uint32_t version = kVersion;
+  uint32_t num_entries = static_cast<uint32_t>(entries.size());
+  file.write(kMagic, 8);
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(&num_entries), sizeof(num_entries));
+  file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(OpeningBookEntry));
+  if (!file) {
+    throw std::runtime_error("Could not write the opening book file " + path + ".");
+  }
+}
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+#include <core/bitboard.h>
+#include <core/opening_book_builder.h>
+#include <core/tree_search_ai.h>
+
+namespace ultimate_tictactoe {
+
+constexpr size_t OpeningBookBuilder::kPositionsPerLogUpdate;
+
+OpeningBookBuilder::OpeningBookBuilder(size_t num_plies, size_t search_depth, size_t num_threads)
+    : num_plies_(num_plies), search_depth_(search_depth), num_threads_(num_threads) {
+  if (search_depth == 0 || num_threads == 0) {
+    throw std::invalid_argument("The search depth and the number of threads must both be positive.");
+  }
+}
+
+vector<SuperBoard> OpeningBookBuilder::GetPositions() const {
+  vector<SuperBoard> positions;
+  if (num_plies_ == 0) {
+    return positions;
+  }
+
+  std::unordered_set<uint64_t> seen_hashes;
+  vector<SuperBoard> current_ply(1, SuperBoard());
+  for (size_t ply = 0; ply < num_plies_; ply++) {
+    positions.insert(positions.end(), current_ply.begin(), current_ply.end());
+    if (ply + 1 == num_plies_) {
+      break;
+    }
+
+    vector<SuperBoard> next_ply;
+    for (const SuperBoard& board : current_ply) {
+      BitBoard bit_board(board);
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        uint16_t valid_cells = bit_board.GetValidCellMask(sub_board);
+        for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+          if (!(valid_cells & (1 << cell))) {
+            continue;
+          }
+          BitBoard next_bit_board = bit_board;
+          next_bit_board.PlayMove(sub_board, cell);
+          if (next_bit_board.IsComplete() || !seen_hashes.insert(next_bit_board.GetCanonicalHash()).second) {
+            continue;
+          }
+          SuperBoard next_board = board;
+          next_board.PlayMove(BitBoard::ToAction(sub_board, cell));
+          next_ply.push_back(next_board);
+        }
+      }
+    }
+    current_ply = std::move(next_ply);
+  }
+  return positions;
+}
+
+vector<OpeningBookEntry> OpeningBookBuilder::Build(std::ostream* log) const {
+  vector<SuperBoard> positions = GetPositions();
+  vector<OpeningBookEntry> entries(positions.size());
+
+  // Each thread takes the next position that has not been taken yet, so threads that get
+  // quick positions are not left idle. Each entry is only written by the thread that took it.
+  std::atomic<size_t> next_position(0);
+  std::atomic<size_t> num_finished(0);
+  std::mutex log_mutex;
+  vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads_; i++) {
+    threads.emplace_back([&]() {
+      for (size_t position = next_position++; position < positions.size(); position = next_position++) {
+        entries[position] = SearchPosition(positions[position]);
+        size_t finished = ++num_finished;
+        if (log != nullptr && (finished % kPositionsPerLogUpdate == 0 || finished == positions.size())) {
+          std::lock_guard<std::mutex> lock(log_mutex);
+          *log << "Searched " << finished << "/" << positions.size() << " positions" << std::endl;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return entries;
+}
+
+OpeningBookEntry OpeningBookBuilder::SearchPosition(const SuperBoard& board) const {
+  TreeSearchAI AI;
+  AI.SetState(board);
+  pair<Action, double> best_action_and_value =
+      AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, search_depth_);
+
+  // The entry is stored for the canonical form of the position, so the move is transformed too.
+  BitBoard bit_board(board);
+  size_t symmetry = bit_board.GetCanonicalSymmetry();
+  Action canonical_move = BitBoard::TransformAction(symmetry, best_action_and_value.first);
+
+  OpeningBookEntry entry;
+  entry.position_hash = bit_board.GetTransformed(symmetry).GetHash();
+  entry.move = static_cast<uint16_t>(BitBoard::SubBoardIndex(canonical_move) * BitBoard::kNumCells +
+                                     BitBoard::CellIndex(canonical_move));
+  entry.value = static_cast<int16_t>(std::lround(best_action_and_value.second * OpeningBook::kValueScale));
+  entry.depth = static_cast<uint32_t>(search_depth_);
+  return entry;
+}
+
+}  // namespace ultimate_tictactoe
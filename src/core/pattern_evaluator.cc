@@ -0,0 +1,181 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <core/pattern_evaluator.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+constexpr size_t kHeaderSize = 12;
+
+// Precomputes, for every sub-board, its position class, and for every mask of cells in it,
+// the sum of 3^cell over the cells of the mask after transforming them by a symmetry that
+// moves the sub-board to the first sub-board of its class (0 for corners, 1 for edges, and 4
+// for the center). A pattern is then the sum for the player to move's marks plus twice the
+// sum for the opponent's.
+struct PatternTable {
+  size_t position_classes[BitBoard::kNumCells];
+  uint16_t cell_sums[BitBoard::kNumCells][BitBoard::kFullMask + 1];
+
+  PatternTable() {
+    const size_t kClassSubBoards[] = {0, 1, 4};
+    for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+      position_classes[sub_board] = (sub_board == 4 ? 2 : sub_board % 2);
+      size_t symmetry = 0;
+      while (BitBoard::TransformIndex(symmetry, sub_board) != kClassSubBoards[position_classes[sub_board]]) {
+        symmetry++;
+      }
+      for (size_t mask = 0; mask <= BitBoard::kFullMask; mask++) {
+        uint16_t sum = 0;
+        for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+          if (mask & (1 << cell)) {
+            uint16_t power = 1;
+            for (size_t i = 0; i < BitBoard::TransformIndex(symmetry, cell); i++) {
+              power *= 3;
+            }
+            sum += power;
+          }
+        }
+        cell_sums[sub_board][mask] = sum;
+      }
+    }
+  }
+};
+
+const PatternTable kPatternTable;
+
+// Precomputes, for every mask of sub-boards that a player cannot win along (those won by the
+// opponent or tied), the mask of sub-boards on a line that contains none of them.
+struct OpenLineTable {
+  uint16_t open_sub_boards[BitBoard::kFullMask + 1];
+
+  OpenLineTable() {
+    for (size_t blocked_sub_boards = 0; blocked_sub_boards <= BitBoard::kFullMask; blocked_sub_boards++) {
+      open_sub_boards[blocked_sub_boards] = 0;
+      for (uint16_t line : BitBoard::kLineMasks) {
+        if ((line & blocked_sub_boards) == 0) {
+          open_sub_boards[blocked_sub_boards] |= line;
+        }
+      }
+    }
+  }
+};
+
+const OpenLineTable kOpenLineTable;
+
+// Returns the index of the weight of the sub-board with the given marks, where the player to
+// move and the opponent can win along lines through the sub-boards of the given masks.
+size_t GetWeightIndex(size_t sub_board, uint16_t marks, uint16_t opponent_marks, uint16_t open_sub_boards,
+                      uint16_t opponent_open_sub_boards) {
+  size_t context = ((open_sub_boards >> sub_board) & 1) | (((opponent_open_sub_boards >> sub_board) & 1) << 1);
+  size_t pattern = kPatternTable.cell_sums[sub_board][marks] + 2 * kPatternTable.cell_sums[sub_board][opponent_marks];
+  return (kPatternTable.position_classes[sub_board] * PatternEvaluator::kNumContexts + context) *
+         PatternEvaluator::kNumPatterns + pattern;
+}
+
+}  // namespace
+
+constexpr char PatternEvaluator::kMagic[9];
+constexpr uint32_t PatternEvaluator::kVersion;
+constexpr size_t PatternEvaluator::kNumPositionClasses;
+constexpr size_t PatternEvaluator::kNumContexts;
+constexpr size_t PatternEvaluator::kNumPatterns;
+constexpr size_t PatternEvaluator::kBiasWeight;
+constexpr size_t PatternEvaluator::kNumWeights;
+constexpr size_t PatternEvaluator::kNumActiveWeights;
+constexpr bool PatternEvaluator::kPrefersBatches;
+constexpr bool PatternEvaluator::kIsSymmetric;
+
+PatternEvaluator::PatternEvaluator() : weights_(kNumWeights, 0) {}
+
+void PatternEvaluator::Load(const string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not open the pattern weight file " + path + ".");
+  }
+  char header[kHeaderSize];
+  uint32_t version = 0;
+  vector<float> weights(kNumWeights);
+  file.read(header, kHeaderSize);
+  std::memcpy(&version, header + 8, sizeof(version));
+  file.read(reinterpret_cast<char*>(weights.data()), kNumWeights * sizeof(float));
+  if (!file || file.peek() != std::ifstream::traits_type::eof() || std::memcmp(header, kMagic, 8) != 0 ||
+      version != kVersion) {
+    throw std::runtime_error("The file " + path + " is not a valid pattern weight file.");
+  }
+  weights_ = std::move(weights);
+}
+
+void PatternEvaluator::Write(const string& path, const vector<float>& weights) {
+  if (weights.size() != kNumWeights) {
+    throw std::invalid_argument("A pattern evaluator has exactly PatternEvaluator::kNumWeights weights.");
+  }
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  uint32_t version = kVersion;
+  file.write(kMagic, 8);
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(weights.data()), kNumWeights * sizeof(float));
+  if (!file) {
+    throw std::runtime_error("Could not write the pattern weight file " + path + ".");
+  }
+}
+
+void PatternEvaluator::SetWeights(const vector<float>& weights) {
+  if (weights.size() != kNumWeights) {
+    throw std::invalid_argument("A pattern evaluator has exactly PatternEvaluator::kNumWeights weights.");
+  }
+  weights_ = weights;
+}
+
+const vector<float>& PatternEvaluator::GetWeights() const {
+  return weights_;
+}
+
+void PatternEvaluator::GetActiveWeights(const BitBoard& board, size_t indices[kNumActiveWeights]) {
+  Player active_player = board.GetCurrentPlayer();
+  Player opponent = (active_player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
+  uint16_t complete_sub_boards = board.GetCompleteSubBoards();
+  uint16_t active_player_open = kOpenLineTable.open_sub_boards[complete_sub_boards &
+                                                               ~board.GetWonSubBoards(active_player)];
+  uint16_t opponent_open = kOpenLineTable.open_sub_boards[complete_sub_boards & ~board.GetWonSubBoards(opponent)];
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    indices[sub_board] = GetWeightIndex(sub_board, board.GetMarks(active_player, sub_board),
+                                        board.GetMarks(opponent, sub_board), active_player_open, opponent_open);
+  }
+  indices[BitBoard::kNumCells] = kBiasWeight;
+}
+
+double PatternEvaluator::Evaluate(const BitBoard& board) const {
+  size_t indices[kNumActiveWeights];
+  GetActiveWeights(board, indices);
+  double sum = 0;
+  for (size_t index : indices) {
+    sum += weights_[index];
+  }
+  return tanh(sum);
+}
+
+void PatternEvaluator::EvaluateBatch(const PositionBatch& batch, double* values) const {
+  uint16_t open_sub_boards[2][PositionBatch::kMaxSize];
+  for (size_t i = 0; i < batch.size; i++) {
+    for (size_t player = 0; player < 2; player++) {
+      open_sub_boards[player][i] =
+          kOpenLineTable.open_sub_boards[batch.complete_sub_boards[i] & ~batch.won_sub_boards[player][i]];
+    }
+    values[i] = 0;
+  }
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    for (size_t i = 0; i < batch.size; i++) {
+      values[i] += weights_[GetWeightIndex(sub_board, batch.marks[0][sub_board][i], batch.marks[1][sub_board][i],
+                                           open_sub_boards[0][i], open_sub_boards[1][i])];
+    }
+  }
+  for (size_t i = 0; i < batch.size; i++) {
+    values[i] = tanh(values[i] + weights_[kBiasWeight]);
+  }
+}
+
+}  // namespace ultimate_tictactoe
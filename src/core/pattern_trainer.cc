@@ -0,0 +1,190 @@
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <core/pattern_trainer.h>
+#include <core/random_playout.h>
+#include <core/tree_search_ai.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+constexpr size_t kNumActiveWeights = PatternEvaluator::kNumActiveWeights;
+
+// Mixes the game index into the seed, so that the games' random moves are not correlated.
+constexpr uint64_t kGameSeedMultiplier = 0x9E3779B97F4A7C15ULL;
+
+}  // namespace
+
+constexpr double PatternTrainer::kWonGameValue;
+constexpr size_t PatternTrainer::kGamesPerLogUpdate;
+
+PatternTrainer::PatternTrainer(size_t search_depth, size_t num_random_plies, size_t num_threads)
+    : search_depth_(search_depth), num_random_plies_(num_random_plies), num_threads_(num_threads) {
+  if (search_depth == 0 || num_threads == 0) {
+    throw std::invalid_argument("The search depth and the number of threads must both be positive.");
+  }
+}
+
+vector<vector<Action>> PatternTrainer::PlayGames(size_t num_games, uint64_t seed, std::ostream* log) const {
+  vector<vector<Action>> games(num_games);
+
+  // As in OpeningBookBuilder::Build, each thread takes the next game that has not been taken yet.
+  std::atomic<size_t> next_game(0);
+  std::atomic<size_t> num_finished(0);
+  std::mutex log_mutex;
+  vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads_; i++) {
+    threads.emplace_back([&]() {
+      for (size_t game = next_game++; game < num_games; game = next_game++) {
+        games[game] = PlayGame(seed ^ ((game + 1) * kGameSeedMultiplier));
+        size_t finished = ++num_finished;
+        if (log != nullptr && (finished % kGamesPerLogUpdate == 0 || finished == num_games)) {
+          std::lock_guard<std::mutex> lock(log_mutex);
+          *log << "Played " << finished << "/" << num_games << " games" << std::endl;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return games;
+}
+
+vector<Action> PatternTrainer::PlayGame(uint64_t seed) const {
+  XorShiftRandom random(seed);
+  TreeSearchAI AI;
+  AI.SetSearchDepth(search_depth_);
+  BitBoard board;
+  vector<Action> moves;
+  while (!board.IsComplete()) {
+    Action move = (moves.size() < num_random_plies_ ? board.GetNthValidMove(random.NextBelow(board.CountValidMoves()))
+                                                    : AI.GetMove());
+    AI.UpdateState(move);
+    board.PlayMove(BitBoard::SubBoardIndex(move), BitBoard::CellIndex(move));
+    moves.push_back(move);
+  }
+  return moves;
+}
+
+void PatternTrainer::AddGame(const vector<Action>& moves) {
+  vector<BitBoard> positions;
+  BitBoard board;
+  for (const Action& move : moves) {
+    size_t sub_board = BitBoard::SubBoardIndex(move);
+    size_t cell = BitBoard::CellIndex(move);
+    if (board.IsComplete() || sub_board >= BitBoard::kNumCells || cell >= BitBoard::kNumCells ||
+        !(board.GetValidCellMask(sub_board) & (1 << cell))) {
+      throw std::invalid_argument("The game has a move that is not valid.");
+    }
+    positions.push_back(board);
+    board.PlayMove(sub_board, cell);
+  }
+  if (!board.IsComplete()) {
+    throw std::invalid_argument("The game is not complete after its moves.");
+  }
+
+  WinState winner = board.GetWinner();
+  for (const BitBoard& position : positions) {
+    double target = 0;
+    if (winner == WinState::kPlayer1Win || winner == WinState::kPlayer2Win) {
+      bool player_to_move_won = (winner == WinState::kPlayer1Win) == (position.GetCurrentPlayer() == Player::kPlayer1);
+      target = (player_to_move_won ? 1 : -1) * atanh(kWonGameValue);
+    }
+    AddPosition(position, target);
+  }
+}
+
+void PatternTrainer::AddPosition(const BitBoard& board, double target) {
+  size_t indices[kNumActiveWeights];
+  PatternEvaluator::GetActiveWeights(board, indices);
+  active_weights_.insert(active_weights_.end(), indices, indices + kNumActiveWeights);
+  targets_.push_back(target);
+}
+
+size_t PatternTrainer::GetNumPositions() const {
+  return targets_.size();
+}
+
+vector<float> PatternTrainer::Fit(double regularization, size_t num_iterations) const {
+  // Minimizes |Aw - b|^2 + regularization * |w|^2, where A has a row per position with a 1 for
+  // each active weight and b holds the targets. With residual r = b - Aw, the gradient
+  // direction is s = A^T r - regularization * w, and the search directions p are kept
+  // conjugate with respect to A^T A + regularization * I.
+  size_t num_positions = targets_.size();
+  vector<double> weights(PatternEvaluator::kNumWeights, 0);
+  vector<double> residuals(targets_);
+  vector<double> gradient(PatternEvaluator::kNumWeights, 0);
+  vector<double> products(num_positions);
+
+  auto compute_gradient = [&]() {
+    for (size_t i = 0; i < weights.size(); i++) {
+      gradient[i] = -regularization * weights[i];
+    }
+    for (size_t position = 0; position < num_positions; position++) {
+      for (size_t i = 0; i < kNumActiveWeights; i++) {
+        gradient[active_weights_[position * kNumActiveWeights + i]] += residuals[position];
+      }
+    }
+  };
+  auto squared_norm = [](const vector<double>& values) {
+    double sum = 0;
+    for (double value : values) {
+      sum += value * value;
+    }
+    return sum;
+  };
+
+  compute_gradient();
+  vector<double> direction(gradient);
+  double gradient_norm = squared_norm(gradient);
+  for (size_t iteration = 0; iteration < num_iterations && gradient_norm > 0; iteration++) {
+    for (size_t position = 0; position < num_positions; position++) {
+      double product = 0;
+      for (size_t i = 0; i < kNumActiveWeights; i++) {
+        product += direction[active_weights_[position * kNumActiveWeights + i]];
+      }
+      products[position] = product;
+    }
+    double step = gradient_norm / (squared_norm(products) + regularization * squared_norm(direction));
+    for (size_t i = 0; i < weights.size(); i++) {
+      weights[i] += step * direction[i];
+    }
+    for (size_t position = 0; position < num_positions; position++) {
+      residuals[position] -= step * products[position];
+    }
+
+    compute_gradient();
+    double next_gradient_norm = squared_norm(gradient);
+    double beta = next_gradient_norm / gradient_norm;
+    for (size_t i = 0; i < direction.size(); i++) {
+      direction[i] = gradient[i] + beta * direction[i];
+    }
+    gradient_norm = next_gradient_norm;
+  }
+  return vector<float>(weights.begin(), weights.end());
+}
+
+double PatternTrainer::GetMeanSquaredError(const vector<float>& weights) const {
+  if (weights.size() != PatternEvaluator::kNumWeights) {
+    throw std::invalid_argument("A pattern evaluator has exactly PatternEvaluator::kNumWeights weights.");
+  }
+  if (targets_.empty()) {
+    return 0;
+  }
+  double sum = 0;
+  for (size_t position = 0; position < targets_.size(); position++) {
+    double value = 0;
+    for (size_t i = 0; i < kNumActiveWeights; i++) {
+      value += weights[active_weights_[position * kNumActiveWeights + i]];
+    }
+    sum += (value - targets_[position]) * (value - targets_[position]);
+  }
+  return sum / static_cast<double>(targets_.size());
+}
+
+}  // namespace ultimate_tictactoe
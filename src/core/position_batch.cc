@@ -0,0 +1,7 @@
+#include <core/position_batch.h>
+
+namespace ultimate_tictactoe {
+
+constexpr size_t PositionBatch::kMaxSize;
+
+}  // namespace ultimate_tictactoe
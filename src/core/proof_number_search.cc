@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <core/proof_number_search.h>
+
+namespace ultimate_tictactoe {
+
+namespace {
+
+// Mixed into the table keys of searches where Player 2 is the attacker.
+const uint64_t kPlayer2AttackerKey = 0x6A09E667F3BCC909ULL;
+
+}  // namespace
+
+constexpr size_t ProofNumberSearch::kDefaultTableSizeLog2;
+constexpr uint32_t ProofNumberSearch::kInfinity;
+
+ProofNumberSearch::ProofNumberSearch(size_t table_size_log2)
+    : table_size_log2_(table_size_log2), generation_(1), attacker_(Player::kPlayer1), max_nodes_(0),
+      nodes_searched_(0), root_winning_move_(0) {}
+
+ProofResult ProofNumberSearch::ProveWin(const SuperBoard& board, size_t max_nodes, Action& winning_move) {
+  if (board.IsComplete()) {
+    throw std::runtime_error("The game is complete, so there is no win to prove.");
+  }
+  if (table_.empty()) {
+    table_.resize(static_cast<size_t>(1) << table_size_log2_, TableEntry{0, 0, {1, 1}});
+  }
+
+  attacker_ = board.GetCurrentPlayer();
+  max_nodes_ = max_nodes;
+  nodes_searched_ = 0;
+  ProofNumbers numbers = Search(BitBoard(board), kInfinity, kInfinity, 0);
+  if (numbers.proof == 0) {
+    winning_move = BitBoard::ToAction(root_winning_move_ / BitBoard::kNumCells,
+                                      root_winning_move_ % BitBoard::kNumCells);
+    return ProofResult::kProven;
+  } else if (numbers.disproof == 0) {
+    return ProofResult::kDisproven;
+  } else {
+    return ProofResult::kUnknown;
+  }
+}
+
+size_t ProofNumberSearch::GetNodesSearched() const {
+  return nodes_searched_;
+}
+
+void ProofNumberSearch::Clear() {
+  // Entries from older generations are ignored, so the table does not need to be wiped.
+  generation_++;
+}
+
+ProofNumberSearch::ProofNumbers ProofNumberSearch::Search(const BitBoard& board, uint32_t proof_threshold,
+                                                          uint32_t disproof_threshold, size_t ply) {
+  nodes_searched_++;
+  bool attacker_to_move = (board.GetCurrentPlayer() == attacker_);
+
+  // The numbers of the children are kept here rather than only in the table, since the table
+  // may drop them.
+  uint8_t moves[BitBoard::kNumCells * BitBoard::kNumCells];
+  ProofNumbers child_numbers[BitBoard::kNumCells * BitBoard::kNumCells];
+  size_t num_moves = 0;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    uint16_t valid_cells = board.GetValidCellMask(sub_board);
+    for (; valid_cells != 0; valid_cells &= valid_cells - 1) {
+      size_t cell = SelectNthSetBit(valid_cells, 0);
+      BitBoard child = board;
+      child.PlayMove(sub_board, cell);
+      moves[num_moves] = static_cast<uint8_t>(sub_board * BitBoard::kNumCells + cell);
+      child_numbers[num_moves] = GetInitialProofNumbers(child);
+      num_moves++;
+    }
+  }
+
+  while (true) {
+    // At the attacker's nodes, one proven move proves the node, and every move must be
+    // disproven to disprove it; at the defender's nodes, it is the other way around.
+    // best_child is the child closest to deciding the node, and second_best_number is the
+    // number that the next closest child has.
+    ProofNumbers numbers = attacker_to_move ? ProofNumbers{kInfinity, 0} : ProofNumbers{0, kInfinity};
+    size_t best_child = 0;
+    uint32_t second_best_number = kInfinity;
+    for (size_t i = 0; i < num_moves; i++) {
+      if (attacker_to_move) {
+        if (child_numbers[i].proof < numbers.proof) {
+          second_best_number = numbers.proof;
+          numbers.proof = child_numbers[i].proof;
+          best_child = i;
+        } else if (child_numbers[i].proof < second_best_number) {
+          second_best_number = child_numbers[i].proof;
+        }
+        numbers.disproof = AddProofNumbers(numbers.disproof, child_numbers[i].disproof);
+      } else {
+        if (child_numbers[i].disproof < numbers.disproof) {
+          second_best_number = numbers.disproof;
+          numbers.disproof = child_numbers[i].disproof;
+          best_child = i;
+        } else if (child_numbers[i].disproof < second_best_number) {
+          second_best_number = child_numbers[i].disproof;
+        }
+        numbers.proof = AddProofNumbers(numbers.proof, child_numbers[i].proof);
+      }
+    }
+
+    if (numbers.proof >= proof_threshold || numbers.disproof >= disproof_threshold || numbers.proof == 0 ||
+        numbers.disproof == 0 || nodes_searched_ >= max_nodes_) {
+      if (ply == 0 && numbers.proof == 0) {
+        root_winning_move_ = moves[best_child];
+      }
+      table_[GetKey(board) & (table_.size() - 1)] = {GetKey(board), generation_, numbers};
+      return numbers;
+    }
+
+    // The child is searched until it is no longer the closest to deciding this node (i.e. its
+    // number passes the second best one), or until this node's thresholds would be reached.
+    uint32_t second_best_threshold = (second_best_number == kInfinity ? kInfinity : second_best_number + 1);
+    ProofNumbers child_thresholds;
+    if (attacker_to_move) {
+      child_thresholds.proof = std::min(proof_threshold, second_best_threshold);
+      child_thresholds.disproof = (disproof_threshold == kInfinity
+                                       ? kInfinity
+                                       : disproof_threshold - numbers.disproof + child_numbers[best_child].disproof);
+    } else {
+      child_thresholds.proof = (proof_threshold == kInfinity
+                                    ? kInfinity
+                                    : proof_threshold - numbers.proof + child_numbers[best_child].proof);
+      child_thresholds.disproof = std::min(disproof_threshold, second_best_threshold);
+    }
+
+    BitBoard child = board;
+    child.PlayMove(moves[best_child] / BitBoard::kNumCells, moves[best_child] % BitBoard::kNumCells);
+    child_numbers[best_child] = Search(child, child_thresholds.proof, child_thresholds.disproof, ply + 1);
+  }
+}
+
+ProofNumberSearch::ProofNumbers ProofNumberSearch::GetInitialProofNumbers(const BitBoard& board) const {
+  WinState winner = board.GetWinner();
+  if (winner != WinState::kInProgress) {
+    bool attacker_won = (winner == WinState::kPlayer1Win && attacker_ == Player::kPlayer1) ||
+                        (winner == WinState::kPlayer2Win && attacker_ == Player::kPlayer2);
+    return attacker_won ? ProofNumbers{0, kInfinity} : ProofNumbers{kInfinity, 0};
+  } else if (board.IsDeadDraw()) {
+    // The game can only end in a tie, so the attacker cannot win.
+    return {kInfinity, 0};
+  }
+
+  // If the player to move can win right away, the node is decided without expanding it.
+  size_t sub_board;
+  size_t cell;
+  if (board.FindWinningMove(sub_board, cell)) {
+    return board.GetCurrentPlayer() == attacker_ ? ProofNumbers{0, kInfinity} : ProofNumbers{kInfinity, 0};
+  }
+
+  const TableEntry& entry = table_[GetKey(board) & (table_.size() - 1)];
+  if (entry.generation == generation_ && entry.key == GetKey(board)) {
+    return entry.numbers;
+  }
+  return {1, 1};
+}
+
+uint64_t ProofNumberSearch::GetKey(const BitBoard& board) const {
+  return attacker_ == Player::kPlayer1 ? board.GetHash() : board.GetHash() ^ kPlayer2AttackerKey;
+}
+
+uint32_t ProofNumberSearch::AddProofNumbers(uint32_t n1, uint32_t n2) {
+  if (n1 == kInfinity || n2 == kInfinity) {
+    return kInfinity;
+  }
+  // Finite sums are capped just below kInfinity, so that they are never mistaken for it.
+  uint64_t sum = static_cast<uint64_t>(n1) + n2;
+  return sum >= kInfinity ? kInfinity - 1 : static_cast<uint32_t>(sum);
+}
+
+}  // namespace ultimate_tictactoe
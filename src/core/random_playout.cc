@@ -0,0 +1,49 @@
+#include <core/random_playout.h>
+
+namespace ultimate_tictactoe {
+
+XorShiftRandom::XorShiftRandom(uint64_t seed) : state_(seed == 0 ? RandomPlayout::kDefaultSeed : seed) {}
+
+constexpr uint64_t RandomPlayout::kDefaultSeed;
+
+RandomPlayout::RandomPlayout(uint64_t seed) : random_(seed), moves_played_(0) {}
+
+WinState RandomPlayout::Play(BitBoard board) {
+  uint16_t valid_cell_masks[BitBoard::kNumCells];
+  while (!board.IsComplete()) {
+    size_t required_sub_board = board.GetRequiredSubBoard();
+    if (required_sub_board != BitBoard::kNoRequiredSubBoard) {
+      // Common case: all valid moves are in a single sub-board.
+      uint16_t mask = board.GetValidCellMask(required_sub_board);
+      board.PlayMove(required_sub_board, SelectNthSetBit(mask, random_.NextBelow(PopCount(mask))));
+    } else {
+      // Gather the valid moves of every sub-board, pick one uniformly at random
+      // among all of them, and then find which sub-board and cell it corresponds to.
+      size_t valid_move_count = 0;
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        valid_cell_masks[sub_board] = board.GetValidCellMask(sub_board);
+        valid_move_count += PopCount(valid_cell_masks[sub_board]);
+      }
+
+      size_t move_index = random_.NextBelow(valid_move_count);
+      size_t sub_board = 0;
+      while (move_index >= PopCount(valid_cell_masks[sub_board])) {
+        move_index -= PopCount(valid_cell_masks[sub_board]);
+        sub_board++;
+      }
+      board.PlayMove(sub_board, SelectNthSetBit(valid_cell_masks[sub_board], move_index));
+    }
+    moves_played_++;
+  }
+  return board.GetWinner();
+}
+
+WinState RandomPlayout::Play(const SuperBoard& board) {
+  return Play(BitBoard(board));
+}
+
+size_t RandomPlayout::GetMovesPlayed() const {
+  return moves_played_;
+}
+
+}  // namespace ultimate_tictactoe
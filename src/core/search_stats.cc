@@ -0,0 +1,88 @@
+#include <core/search_stats.h>
+
+namespace ultimate_tictactoe {
+
+void SearchStats::Reset() {
+  nodes = 0;
+  leaf_evaluations = 0;
+  terminal_hits = 0;
+  endgame_solves = 0;
+  endgame_solver_failures = 0;
+  proof_search_nodes = 0;
+  immediate_wins = 0;
+  unsafe_actions_skipped = 0;
+  symmetric_actions_skipped = 0;
+  late_move_reductions = 0;
+  late_move_researches = 0;
+  futility_prunes = 0;
+  razorings = 0;
+  beta_cutoffs = 0;
+  first_move_cutoffs = 0;
+  nodes_per_ply.clear();
+  eval_cache_probes = 0;
+  eval_cache_hits = 0;
+  elapsed_seconds = 0;
+}
+
+void SearchStats::RecordNode(size_t ply) {
+  nodes++;
+  if (ply >= nodes_per_ply.size()) {
+    nodes_per_ply.resize(ply + 1, 0);
+  }
+  nodes_per_ply[ply]++;
+}
+
+void SearchStats::RecordCutoff(size_t action_index) {
+  beta_cutoffs++;
+  if (action_index == 0) {
+    first_move_cutoffs++;
+  }
+}
+
+double SearchStats::GetFirstMoveCutoffRate() const {
+  if (beta_cutoffs == 0) {
+    return 0;
+  }
+  return static_cast<double>(first_move_cutoffs) / beta_cutoffs;
+}
+
+double SearchStats::GetEvaluationCacheHitRate() const {
+  if (eval_cache_probes == 0) {
+    return 0;
+  }
+  return static_cast<double>(eval_cache_hits) / eval_cache_probes;
+}
+
+double SearchStats::GetEffectiveBranchingFactor(size_t ply) const {
+  if (ply + 1 >= nodes_per_ply.size() || nodes_per_ply[ply] == 0) {
+    return 0;
+  }
+  return static_cast<double>(nodes_per_ply[ply + 1]) / nodes_per_ply[ply];
+}
+
+double SearchStats::GetNodesPerSecond() const {
+  if (elapsed_seconds <= 0) {
+    return 0;
+  }
+  return nodes / elapsed_seconds;
+}
+
+std::ostream& operator<<(std::ostream& os, const SearchStats& stats) {
+  os << "nodes " << stats.nodes << ", leaves " << stats.leaf_evaluations << ", terminals " << stats.terminal_hits
+     << ", solved " << stats.endgame_solves << " (gave up " << stats.endgame_solver_failures << ")"
+     << ", proof nodes " << stats.proof_search_nodes << ", wins in one " << stats.immediate_wins
+     << ", unsafe skipped " << stats.unsafe_actions_skipped << ", symmetric skipped " << stats.symmetric_actions_skipped
+     << ", reduced " << stats.late_move_reductions << " (re-searched " << stats.late_move_researches << ")"
+     << ", futile " << stats.futility_prunes << ", razored " << stats.razorings
+     << ", cutoffs " << stats.beta_cutoffs << " (first move " << stats.GetFirstMoveCutoffRate() * 100 << "%)"
+     << ", eval cache hits " << stats.eval_cache_hits << "/" << stats.eval_cache_probes
+     << ", time " << stats.elapsed_seconds << "s"
+     << ", nps " << stats.GetNodesPerSecond() << std::endl;
+  os << "effective branching factor by ply:";
+  for (size_t ply = 0; ply + 1 < stats.nodes_per_ply.size(); ply++) {
+    os << " " << stats.GetEffectiveBranchingFactor(ply);
+  }
+  return os << std::endl;
+}
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,13 @@
+#include <core/selective_search_settings.h>
+
+namespace ultimate_tictactoe {
+
+SelectiveSearchSettings SelectiveSearchSettings::Disabled() {
+  return {0, 0, 0, 0, 0, 0, 0};
+}
+
+SelectiveSearchSettings SelectiveSearchSettings::Suggested() {
+  return {4, 3, 2, 1, 0.3, 0, 0};
+}
+
+}  // namespace ultimate_tictactoe
@@ -12,13 +12,20 @@ using std::vector;
 using std::string;
 
 SuperBoard::SuperBoard() : current_player_(Player::kPlayer1),
-                           next_sub_board_row_(0), next_sub_board_col_(0), required_next_sub_board_(false) {}
+                           next_sub_board_row_(0), next_sub_board_col_(0), required_next_sub_board_(false),
+                           num_winnable_lines_(2 * kBoardSize + 2) {}
 
 void SuperBoard::PlayMove(const Action& a) {
   RequireValidMove(a);
   
-  grid_[a.row_in_board][a.col_in_board].PlayMove(a, current_player_);
+  SubBoard& sub_board = grid_[a.row_in_board][a.col_in_board];
+  sub_board.PlayMove(a, current_player_);
   move_history_.push_back({a, required_next_sub_board_});
+  if (sub_board.IsComplete()) {
+    // The sub-board was incomplete before the move, since the move was valid.
+    num_winnable_lines_ -= CountWinnableLinesThrough(a.row_in_board, a.col_in_board, WinState::kInProgress) -
+                           CountWinnableLinesThrough(a.row_in_board, a.col_in_board, sub_board.GetWinner());
+  }
   
   // If the grid that would be required is complete (cannot be played on anymore)
   // then there is no required sub-board. Otherwise, there is a required sub-board.
@@ -35,7 +42,13 @@ void SuperBoard::ReverseAction() {
   }
   
   Action a = move_history_[move_history_.size() - 1].a;
-  grid_[a.row_in_board][a.col_in_board].ReverseAction(a);
+  SubBoard& sub_board = grid_[a.row_in_board][a.col_in_board];
+  if (sub_board.IsComplete()) {
+    // The sub-board is incomplete again once the move is reversed.
+    num_winnable_lines_ += CountWinnableLinesThrough(a.row_in_board, a.col_in_board, WinState::kInProgress) -
+                           CountWinnableLinesThrough(a.row_in_board, a.col_in_board, sub_board.GetWinner());
+  }
+  sub_board.ReverseAction(a);
   required_next_sub_board_ = move_history_[move_history_.size() - 1].required_next_sub_board_exists;
   next_sub_board_row_ = a.row_in_board;
   next_sub_board_col_ = a.col_in_board;
@@ -83,6 +96,10 @@ bool SuperBoard::NextRequiredSubBoardExists() const {
   return required_next_sub_board_;
 }
 
+bool SuperBoard::IsDeadDraw() const {
+  return num_winnable_lines_ == 0;
+}
+
 bool SuperBoard::SubBoardOutOfBounds(const Action& a) const {
   return a.row_in_board < 0 || a.row_in_board >= kBoardSize ||
       a.col_in_board < 0 || a.col_in_board >= kBoardSize;
@@ -100,5 +117,40 @@ void SuperBoard::SwapCurrentPlayer() {
     current_player_ = Player::kPlayer1;
   }
 }
+
+size_t SuperBoard::CountWinnableLinesThrough(size_t row, size_t col, WinState sub_board_state) const {
+  WinState row_states[kBoardSize], col_states[kBoardSize];
+  WinState diagonal_states[kBoardSize], anti_diagonal_states[kBoardSize];
+  for (size_t i = 0; i < kBoardSize; i++) {
+    row_states[i] = (i == col ? sub_board_state : grid_[row][i].GetWinner());
+    col_states[i] = (i == row ? sub_board_state : grid_[i][col].GetWinner());
+    diagonal_states[i] = (i == row ? sub_board_state : grid_[i][i].GetWinner());
+    anti_diagonal_states[i] = (i == row ? sub_board_state : grid_[i][kBoardSize - 1 - i].GetWinner());
+  }
+
+  size_t num_lines = 0;
+  num_lines += IsLineWinnable(row_states) ? 1 : 0;
+  num_lines += IsLineWinnable(col_states) ? 1 : 0;
+  if (row == col) {
+    num_lines += IsLineWinnable(diagonal_states) ? 1 : 0;
+  }
+  if (row + col == kBoardSize - 1) {
+    num_lines += IsLineWinnable(anti_diagonal_states) ? 1 : 0;
+  }
+  return num_lines;
+}
+
+bool SuperBoard::IsLineWinnable(const WinState line_states[]) {
+  bool has_player1_win = false;
+  bool has_player2_win = false;
+  for (size_t i = 0; i < kBoardSize; i++) {
+    if (line_states[i] == WinState::kTie) {
+      return false;
+    }
+    has_player1_win = has_player1_win || line_states[i] == WinState::kPlayer1Win;
+    has_player2_win = has_player2_win || line_states[i] == WinState::kPlayer2Win;
+  }
+  return !(has_player1_win && has_player2_win);
+}
   
 }  // namespace ultimate_tictactoe
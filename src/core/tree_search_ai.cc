@@ -1,6 +1,9 @@
 #include <algorithm>
 #include <exception>
 #include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 
 #include <core/tree_search_ai.h>
 
@@ -8,17 +11,76 @@ namespace ultimate_tictactoe {
   
 using std::max;
 
-Action TreeSearchAI::GetMove() {
+template <typename Evaluator>
+constexpr double BasicTreeSearchAI<Evaluator>::kWinValue;
+template <typename Evaluator>
+constexpr double BasicTreeSearchAI<Evaluator>::kWinDistanceStep;
+template <typename Evaluator>
+constexpr size_t BasicTreeSearchAI<Evaluator>::kSuggestedEndgameSolverThreshold;
+template <typename Evaluator>
+constexpr size_t BasicTreeSearchAI<Evaluator>::kNoEndgameSolverFailure;
+template <typename Evaluator>
+constexpr size_t BasicTreeSearchAI<Evaluator>::kSuggestedProofSearchNodes;
+template <typename Evaluator>
+constexpr size_t BasicTreeSearchAI<Evaluator>::kNodesPerClockCheck;
+template <typename Evaluator>
+constexpr size_t BasicTreeSearchAI<Evaluator>::kMaxFrontierDepth;
+template <typename Evaluator>
+constexpr double BasicTreeSearchAI<Evaluator>::kFreeMoveOrderingCost;
+template <typename Evaluator>
+constexpr double BasicTreeSearchAI<Evaluator>::kOpponentThreatOrderingCost;
+template <typename Evaluator>
+constexpr double BasicTreeSearchAI<Evaluator>::kCaptureOrderingValue;
+template <typename Evaluator>
+constexpr double BasicTreeSearchAI<Evaluator>::kOwnThreatOrderingCost;
+
+template <typename Evaluator>
+BasicTreeSearchAI<Evaluator>::BasicTreeSearchAI()
+    : ponder_finished_(false), has_pondered_reply_(false), pondered_reply_{0, 0, 0, 0}, completed_search_depth_(0),
+      opening_book_(nullptr), endgame_solver_threshold_(0),
+      endgame_solver_failed_ply_(kNoEndgameSolverFailure), proof_search_nodes_(0),
+      has_unrecorded_proof_search_(false), unrecorded_proof_search_nodes_(0),
+      selective_search_(SelectiveSearchSettings::Disabled()), stepped_search_running_(false),
+      stepped_search_done_(false), stepped_search_result_{0, 0, 0, 0}, search_ply_(0), search_stats_log_(nullptr),
+      on_previous_principal_variation_(false) {
+  search_stats_.Reset();
+}
+
+template <typename Evaluator>
+BasicTreeSearchAI<Evaluator>::~BasicTreeSearchAI() {
+  CancelSearch();
+  StopPondering();
+}
+
+template <typename Evaluator>
+Action BasicTreeSearchAI<Evaluator>::GetMove() {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
   if (state_.IsComplete()) {
     throw std::runtime_error("The game state (stored by the AI) is complete, so there are no legal moves to make.");
   }
-  
+
+  Action move;
+  if (ProbeOpeningBook(move) || ProveForcedWin(move) || TakePonderedReply(move)) {
+    has_pondered_reply_ = false;
+    LogSearchStats();
+    return move;
+  }
+
   // We don't have any bounds at the highest level of searching (the current state), so we pass in the loosest
-  // bounds possible, which are -1 and 1 for alpha and beta, respectively.
-  return EvaluateStateWithSearch(-1, 1, search_depth_on_get_move).first;
+  // bounds possible, which are -kWinValue and kWinValue for alpha and beta, respectively.
+  BeginSearchStats();
+  ClearEndgameSolver();
+  Action best_action = EvaluateStateWithSearch(-kWinValue, kWinValue, search_depth_on_get_move).first;
+  SetPrincipalVariation(principal_variations_[0]);
+  EndSearchStats();
+  LogSearchStats();
+  return best_action;
 }
 
-double TreeSearchAI::EvaluateState() const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::EvaluateState() const {
   Player active_player = state_.GetCurrentPlayer();
   Player opponent = (active_player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
   double active_player_state_value = TwoDimVectorDotProduct(ComputeSubBoardWinChanceMetrics(active_player),
@@ -28,34 +90,338 @@ double TreeSearchAI::EvaluateState() const {
   return RescaleEvaluation(active_player_state_value - opponent_state_value);
 }
 
-pair<Action, double> TreeSearchAI::EvaluateStateWithSearch(double alpha, double beta, size_t depth_to_search) {
-  if (state_.IsComplete()) {
-    // If game is done, return exact evaluation
+template <typename Evaluator>
+pair<Action, double> BasicTreeSearchAI<Evaluator>::SearchFrontier(const BitBoard& board, double, double,
+                                                                  FrontierDepth<0>) {
+  search_stats_.RecordNode(search_ply_);
+  ResetPrincipalVariation(search_ply_);
+
+  pair<Action, double> solved_action_and_value;
+  if (board.IsComplete() || (search_ply_ > 0 && board.IsDeadDraw())) {
+    search_stats_.terminal_hits++;
     return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize},
-                               GetEndOfGameEvaluation()};
-  } else if (depth_to_search == 0) {
-    // If no more levels to search, return heuristic/approximate evaluation
+                               GetEndOfGameEvaluation(board, search_ply_)};
+  } else if (SolveEndgame(board, search_ply_, solved_action_and_value)) {
+    principal_variations_[search_ply_].assign(1, solved_action_and_value.first);
+    return solved_action_and_value;
+  }
+  search_stats_.leaf_evaluations++;
+  return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize},
+                             EvaluateLeaf(board)};
+}
+
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::EvaluateLeaf(const BitBoard& board) {
+  if (!evaluation_cache_.IsEnabled()) {
+    return evaluator_.Evaluate(board);
+  }
+  search_stats_.eval_cache_probes++;
+  double value = 0;
+  if (evaluation_cache_.Probe(board.GetHash(), value)) {
+    search_stats_.eval_cache_hits++;
+    return value;
+  }
+  value = evaluator_.Evaluate(board);
+  evaluation_cache_.Store(board.GetHash(), value);
+  return value;
+}
+
+template <typename Evaluator>
+template <size_t kDepth>
+pair<Action, double> BasicTreeSearchAI<Evaluator>::SearchFrontier(const BitBoard& board, double alpha, double beta,
+                                                                  FrontierDepth<kDepth>) {
+  search_stats_.RecordNode(search_ply_);
+  ResetPrincipalVariation(search_ply_);
+
+  // The same steps as EvaluateStateWithSearch, on the board instead of state_.
+  pair<Action, double> solved_action_and_value;
+  if (board.IsComplete() || (search_ply_ > 0 && board.IsDeadDraw())) {
+    search_stats_.terminal_hits++;
     return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize},
-                               EvaluateState()};
+                               GetEndOfGameEvaluation(board, search_ply_)};
+  } else if (SolveEndgame(board, search_ply_, solved_action_and_value)) {
+    principal_variations_[search_ply_].assign(1, solved_action_and_value.first);
+    return solved_action_and_value;
+  }
+
+  alpha = max(alpha, -GetWinValue(search_ply_ + 2));
+  beta = std::min(beta, GetWinValue(search_ply_ + 1));
+  if (alpha >= beta) {
+    return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize}, alpha};
+  }
+
+  Action winning_action;
+  if (FindImmediateWin(board, winning_action)) {
+    principal_variations_[search_ply_].assign(1, winning_action);
+    return {winning_action, GetWinValue(search_ply_ + 1)};
+  }
+
+  size_t depth_to_search = kDepth;
+  bool prune_quiet_actions = false;
+  double pruned_value;
+  if (search_ply_ > 0 &&
+      PrepareSelectiveSearch(board, alpha, beta, depth_to_search, prune_quiet_actions, pruned_value)) {
+    return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize}, pruned_value};
+  }
+  if (depth_to_search < kDepth) {
+    // Razored down to a single level
+    return SearchFrontierActions<0>(board, alpha, beta, depth_to_search, prune_quiet_actions, BatchesChildren<0>());
+  }
+  return SearchFrontierActions<kDepth - 1>(board, alpha, beta, depth_to_search, prune_quiet_actions,
+                                           BatchesChildren<kDepth - 1>());
+}
+
+template <typename Evaluator>
+template <size_t kChildDepth>
+pair<Action, double> BasicTreeSearchAI<Evaluator>::SearchFrontierActions(const BitBoard& board, double alpha,
+                                                                         double beta, size_t depth_to_search,
+                                                                         bool prune_quiet_actions, std::false_type) {
+  // Late move reductions never apply this close to the leaves (see GetLateMoveReduction), so
+  // unlike in EvaluateStateWithSearch, actions are never searched again.
+  vector<Action> valid_actions = GetActionsToSearch(board, depth_to_search);
+  bool previous_principal_variation_action_first =
+      on_previous_principal_variation_ && MovePreviousPrincipalVariationActionFirst(valid_actions);
+  Action best_action = valid_actions[0];
+  for (size_t action_index = 0; action_index < valid_actions.size(); action_index++) {
+    const Action& a = valid_actions[action_index];
+    BitBoard child = board;
+    child.PlayMove(BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+    if (prune_quiet_actions && action_index > 0 && IsQuietAction(child, a)) {
+      search_stats_.futility_prunes++;
+      continue;
+    }
+
+    on_previous_principal_variation_ = previous_principal_variation_action_first && action_index == 0;
+    evaluator_.PlayMove(board.GetCurrentPlayer(), BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+    search_ply_++;
+    double current_action_value = -SearchFrontier(child, -beta, -alpha, FrontierDepth<kChildDepth>()).second;
+    search_ply_--;
+    evaluator_.ReverseMove();
+
+    if (stop_requested_) {
+      return {best_action, alpha};
+    }
+    if (current_action_value > alpha) {
+      alpha = current_action_value;
+      best_action = a;
+      UpdatePrincipalVariation(a);
+    }
+    if (current_action_value >= beta) {
+      search_stats_.RecordCutoff(action_index);
+      return {a, alpha};
+    }
+  }
+  return {best_action, alpha};
+}
+
+template <typename Evaluator>
+template <size_t kChildDepth>
+pair<Action, double> BasicTreeSearchAI<Evaluator>::SearchFrontierActions(const BitBoard& board, double alpha,
+                                                                         double beta, size_t depth_to_search,
+                                                                         bool prune_quiet_actions, std::true_type) {
+  vector<Action> valid_actions = GetActionsToSearch(board, depth_to_search);
+  bool previous_principal_variation_action_first =
+      on_previous_principal_variation_ && MovePreviousPrincipalVariationActionFirst(valid_actions);
+
+  // The first action is searched before the others are batched, since it is often enough for
+  // a beta cutoff (especially on the previous principal variation), and then evaluating the
+  // others would be wasted.
+  FrontierLeaf leaves[PositionBatch::kMaxSize];
+  double leaf_values[PositionBatch::kMaxSize];
+  leaves[0] = FrontierLeaf::kSearched;
+  Action best_action = valid_actions[0];
+  for (size_t action_index = 0; action_index < valid_actions.size(); action_index++) {
+    if (action_index == 1) {
+      PrepareFrontierLeaves(evaluator_, board, valid_actions, prune_quiet_actions, leaves, leaf_values);
+    }
+    const Action& a = valid_actions[action_index];
+    FrontierLeaf leaf = leaves[action_index];
+    if (leaf == FrontierLeaf::kPruned) {
+      search_stats_.futility_prunes++;
+      continue;
+    }
+
+    // The steps of SearchFrontier<0> (with the same stats), for the leaves whose value was found.
+    on_previous_principal_variation_ = previous_principal_variation_action_first && action_index == 0;
+    double current_action_value;
+    if (leaf == FrontierLeaf::kSearched) {
+      BitBoard child = board;
+      child.PlayMove(BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+      evaluator_.PlayMove(board.GetCurrentPlayer(), BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+      search_ply_++;
+      current_action_value = -SearchFrontier(child, -beta, -alpha, FrontierDepth<0>()).second;
+      search_ply_--;
+      evaluator_.ReverseMove();
+    } else {
+      search_stats_.RecordNode(search_ply_ + 1);
+      ResetPrincipalVariation(search_ply_ + 1);
+      if (leaf == FrontierLeaf::kTerminal) {
+        search_stats_.terminal_hits++;
+      } else {
+        search_stats_.leaf_evaluations++;
+        if (evaluation_cache_.IsEnabled()) {
+          search_stats_.eval_cache_probes++;
+          search_stats_.eval_cache_hits += (leaf == FrontierLeaf::kCached ? 1 : 0);
+        }
+      }
+      current_action_value = -leaf_values[action_index];
+    }
+
+    if (stop_requested_) {
+      return {best_action, alpha};
+    }
+    if (current_action_value > alpha) {
+      alpha = current_action_value;
+      best_action = a;
+      UpdatePrincipalVariation(a);
+    }
+    if (current_action_value >= beta) {
+      search_stats_.RecordCutoff(action_index);
+      return {a, alpha};
+    }
+  }
+  return {best_action, alpha};
+}
+
+template <typename Evaluator>
+template <typename BatchEvaluator>
+void BasicTreeSearchAI<Evaluator>::PrepareFrontierLeaves(const BatchEvaluator& evaluator, const BitBoard& board,
+                                                         const vector<Action>& valid_actions, bool prune_quiet_actions,
+                                                         FrontierLeaf* leaves, double* leaf_values) {
+  uint64_t leaf_hashes[PositionBatch::kMaxSize];
+  size_t batch_actions[PositionBatch::kMaxSize];
+  PositionBatch batch;
+  for (size_t action_index = 1; action_index < valid_actions.size(); action_index++) {
+    const Action& a = valid_actions[action_index];
+    BitBoard child = board;
+    child.PlayMove(BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+    if (prune_quiet_actions && IsQuietAction(child, a)) {
+      leaves[action_index] = FrontierLeaf::kPruned;
+    } else if (child.IsComplete() || child.IsDeadDraw()) {
+      leaves[action_index] = FrontierLeaf::kTerminal;
+      leaf_values[action_index] = GetEndOfGameEvaluation(child, search_ply_ + 1);
+    } else if (ShouldSolveEndgame(child, search_ply_ + 1)) {
+      leaves[action_index] = FrontierLeaf::kSearched;
+    } else if (evaluation_cache_.Probe(child.GetHash(), leaf_values[action_index])) {
+      leaves[action_index] = FrontierLeaf::kCached;
+    } else {
+      leaves[action_index] = FrontierLeaf::kEvaluated;
+      leaf_hashes[action_index] = child.GetHash();
+      batch_actions[batch.size] = action_index;
+      batch.Add(child, BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+    }
+  }
+
+  double batch_values[PositionBatch::kMaxSize];
+  evaluator.EvaluateBatch(batch, batch_values);
+  for (size_t i = 0; i < batch.size; i++) {
+    leaf_values[batch_actions[i]] = batch_values[i];
+    evaluation_cache_.Store(leaf_hashes[batch_actions[i]], batch_values[i]);
+  }
+}
+
+template <typename Evaluator>
+pair<Action, double> BasicTreeSearchAI<Evaluator>::EvaluateStateWithSearch(double alpha, double beta,
+                                                                           size_t depth_to_search) {
+  if (search_ply_ == 0) {
+    // The state the search starts from, which the evaluator follows from here on
+    evaluator_.Reset(BitBoard(state_));
+  }
+  if (depth_to_search <= kMaxFrontierDepth) {
+    BitBoard board(state_);
+    if (depth_to_search == 2) {
+      return SearchFrontier(board, alpha, beta, FrontierDepth<2>());
+    } else if (depth_to_search == 1) {
+      return SearchFrontier(board, alpha, beta, FrontierDepth<1>());
+    }
+    return SearchFrontier(board, alpha, beta, FrontierDepth<0>());
+  }
+
+  search_stats_.RecordNode(search_ply_);
+  ResetPrincipalVariation(search_ply_);
+
+  pair<Action, double> solved_action_and_value;
+  if (state_.IsComplete() || (search_ply_ > 0 && state_.IsDeadDraw())) {
+    // If game is done (or can only end in a tie), return exact evaluation. Dead draws at the
+    // root are still searched, so that there is an action to return.
+    search_stats_.terminal_hits++;
+    return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize},
+                               GetEndOfGameEvaluation(search_ply_)};
+  } else if (SolveEndgame(search_ply_, solved_action_and_value)) {
+    // The value is exact, so there is no need to search deeper (or to use the heuristic).
+    principal_variations_[search_ply_].assign(1, solved_action_and_value.first);
+    return solved_action_and_value;
   } else {
+    // Mate distance pruning: the best possible result is winning with the next action, and the worst is losing
+    // after the opponent's reply.
+    alpha = max(alpha, -GetWinValue(search_ply_ + 2));
+    beta = std::min(beta, GetWinValue(search_ply_ + 1));
+    if (alpha >= beta) {
+      return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize}, alpha};
+    }
+
+    BitBoard board(state_);
+    Action winning_action;
+    if (FindImmediateWin(board, winning_action)) {
+      principal_variations_[search_ply_].assign(1, winning_action);
+      return {winning_action, GetWinValue(search_ply_ + 1)};
+    }
+
+    bool prune_quiet_actions = false;
+    double pruned_value;
+    if (search_ply_ > 0 &&
+        PrepareSelectiveSearch(board, alpha, beta, depth_to_search, prune_quiet_actions, pruned_value)) {
+      return {Action{state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize}, pruned_value};
+    }
+
     // Search all possible actions and check against/update alpha and beta
-    vector<Action> valid_actions = GetValidActions();
+    vector<Action> valid_actions = GetActionsToSearch(board, depth_to_search);
+    bool previous_principal_variation_action_first =
+        on_previous_principal_variation_ && MovePreviousPrincipalVariationActionFirst(valid_actions);
     Action best_action = valid_actions[0];
-    for (const Action& a : valid_actions) {
-      state_.PlayMove(a);
-      double current_action_value = -EvaluateStateWithSearch(-beta, -alpha, depth_to_search - 1).second;
-      state_.ReverseAction();
+    for (size_t action_index = 0; action_index < valid_actions.size(); action_index++) {
+      const Action& a = valid_actions[action_index];
+      PlaySearchAction(a);
+      bool is_quiet = IsQuietAction(a);
+      if (prune_quiet_actions && action_index > 0 && is_quiet) {
+        search_stats_.futility_prunes++;
+        ReverseSearchAction();
+        continue;
+      }
+
+      on_previous_principal_variation_ = previous_principal_variation_action_first && action_index == 0;
+      size_t reduction = GetLateMoveReduction(depth_to_search, action_index, is_quiet);
+      if (reduction > 0) {
+        search_stats_.late_move_reductions++;
+      }
+      search_ply_++;
+      double current_action_value = -EvaluateStateWithSearch(-beta, -alpha, depth_to_search - 1 - reduction).second;
+      if (reduction > 0 && current_action_value > alpha && !stop_requested_) {
+        // The reduced search was wrong about the action, so it is searched again at full depth.
+        search_stats_.late_move_researches++;
+        on_previous_principal_variation_ = previous_principal_variation_action_first && action_index == 0;
+        current_action_value = -EvaluateStateWithSearch(-beta, -alpha, depth_to_search - 1).second;
+      }
+      search_ply_--;
+      ReverseSearchAction();
+
+      // Abandon the search if it was stopped (the result will be discarded).
+      if (stop_requested_) {
+        return {best_action, alpha};
+      }
       
       // If the action found is better than the minimum guarantee, update the best move so far, and 
       // update the minimum guarantee of the active player's score
       if (current_action_value > alpha) {
         alpha = current_action_value;
         best_action = a;
+        UpdatePrincipalVariation(a);
       }
       
       // Return early if the state can be pruned (if opponent plays optimally, this state will
       // never be reached).
       if (current_action_value >= beta) {
+        search_stats_.RecordCutoff(action_index);
         return {a, alpha};
       }
     }
@@ -63,11 +429,851 @@ pair<Action, double> TreeSearchAI::EvaluateStateWithSearch(double alpha, double
   }
 }
 
-void TreeSearchAI::SetSearchDepth(size_t search_depth) {
+template <typename Evaluator>
+vector<AnalysisLine> BasicTreeSearchAI<Evaluator>::EvaluateTopActions(size_t num_lines, size_t depth_to_search) {
+  if (state_.IsComplete()) {
+    throw std::runtime_error("The game state (stored by the AI) is complete, so there are no actions to evaluate.");
+  }
+  if (num_lines == 0 || depth_to_search == 0) {
+    throw std::invalid_argument("The number of lines and the search depth must both be positive.");
+  }
+
+  BeginSearchStats();
+  ClearEndgameSolver();
+  search_stats_.RecordNode(0);
+  evaluator_.Reset(BitBoard(state_));
+  vector<AnalysisLine> lines;
+  for (const Action& a : GetValidActions()) {
+    // Until the list is full, every action can make it, so the full window is used.
+    double alpha = (lines.size() < num_lines ? -kWinValue : lines.back().value);
+    PlaySearchAction(a);
+    search_ply_ = 1;
+    double action_value = -EvaluateStateWithSearch(-kWinValue, -alpha, depth_to_search - 1).second;
+    search_ply_ = 0;
+    ReverseSearchAction();
+
+    // Actions that fail low (value <= alpha) only have an upper bound on their value, but they
+    // are not among the best num_lines actions anyway. The rest have exact values.
+    if (lines.size() < num_lines || action_value > alpha) {
+      vector<Action> principal_variation(1, a);
+      principal_variation.insert(principal_variation.end(), principal_variations_[1].begin(),
+                                 principal_variations_[1].end());
+
+      // Insert after the lines with equal values, so that earlier actions win ties.
+      vector<AnalysisLine>::iterator position = lines.begin();
+      while (position != lines.end() && position->value >= action_value) {
+        position++;
+      }
+      lines.insert(position, {a, action_value, principal_variation});
+      if (lines.size() > num_lines) {
+        lines.pop_back();
+      }
+    }
+  }
+  EndSearchStats();
+  return lines;
+}
+
+template <typename Evaluator>
+std::shared_future<Action> BasicTreeSearchAI<Evaluator>::StartSearch() {
+  StopPondering();
+  AbandonSteppedSearch();
+  completed_search_depth_ = 0;
+  return AI::StartSearch();
+}
+
+template <typename Evaluator>
+size_t BasicTreeSearchAI<Evaluator>::GetCompletedSearchDepth() const {
+  return completed_search_depth_;
+}
+
+template <typename Evaluator>
+vector<Action> BasicTreeSearchAI<Evaluator>::GetPrincipalVariation() const {
+  std::lock_guard<std::mutex> lock(principal_variation_mutex_);
+  return principal_variation_;
+}
+
+template <typename Evaluator>
+const SearchStats& BasicTreeSearchAI<Evaluator>::GetSearchStats() const {
+  return search_stats_;
+}
+
+template <typename Evaluator>
+Evaluator& BasicTreeSearchAI<Evaluator>::GetEvaluator() {
+  return evaluator_;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::InvalidateEvaluationCache() {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  evaluation_cache_.Clear();
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetSearchStatsLog(std::ostream* log) {
+  search_stats_log_ = log;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::BeginSteppedSearch() {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  if (state_.IsComplete()) {
+    throw std::runtime_error("The game state (stored by the AI) is complete, so there are no legal moves to make.");
+  }
+
+  stepped_search_running_ = true;
+  if (ProbeOpeningBook(stepped_search_result_) || ProveForcedWin(stepped_search_result_) ||
+      TakePonderedReply(stepped_search_result_)) {
+    has_pondered_reply_ = false;
+    stepped_search_done_ = true;
+    return;
+  }
+
+  // The elapsed time is added up over the calls to StepSearch, rather than measured from now.
+  BeginSearchStats();
+  ClearEndgameSolver();
+  pair<Action, double> solved_action_and_value;
+  if (SolveEndgame(0, solved_action_and_value)) {
+    // Same as EvaluateStateWithSearch, which solves the state before searching it
+    search_stats_.RecordNode(0);
+    stepped_search_result_ = solved_action_and_value.first;
+    stepped_search_done_ = true;
+    SetPrincipalVariation(vector<Action>(1, solved_action_and_value.first));
+  } else if (search_depth_on_get_move == 0) {
+    // Same special action as returned by EvaluateStateWithSearch
+    stepped_search_result_ = {state_.kBoardSize, state_.kBoardSize, state_.kBoardSize, state_.kBoardSize};
+    stepped_search_done_ = true;
+    SetPrincipalVariation(vector<Action>());
+  } else {
+    search_stats_.RecordNode(0);
+    ResetPrincipalVariation(0);
+    BitBoard board(state_);
+    evaluator_.Reset(board);
+    if (FindImmediateWin(board, stepped_search_result_)) {
+      // Same as EvaluateStateWithSearch, which returns an immediate win without searching
+      stepped_search_done_ = true;
+      SetPrincipalVariation(vector<Action>(1, stepped_search_result_));
+      return;
+    }
+    vector<Action> valid_actions = GetActionsToSearch(board, search_depth_on_get_move);
+    Action first_action = valid_actions[0];
+    // The window is narrowed by mate distance pruning, as in EvaluateStateWithSearch.
+    search_stack_.push_back({-GetWinValue(2), GetWinValue(1), search_depth_on_get_move, std::move(valid_actions), 0,
+                             first_action, false, 0, false});
+  }
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::StepSearch(std::chrono::milliseconds time_slice) {
+  if (!stepped_search_running_) {
+    throw std::logic_error("No stepped search has been begun, so there is no search to step.");
+  }
+
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point end_time = start_time + time_slice;
+  bool was_done = stepped_search_done_;
+  while (!stepped_search_done_) {
+    for (size_t i = 0; i < kNodesPerClockCheck && !stepped_search_done_; i++) {
+      AdvanceSteppedSearch();
+    }
+    if (std::chrono::steady_clock::now() >= end_time) {
+      break;
+    }
+  }
+
+  search_stats_.elapsed_seconds +=
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  if (stepped_search_done_ && !was_done) {
+    LogSearchStats();
+  }
+  return stepped_search_done_;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::IsSteppedSearchRunning() const {
+  return stepped_search_running_;
+}
+
+template <typename Evaluator>
+Action BasicTreeSearchAI<Evaluator>::FinishSteppedSearch() {
+  if (!stepped_search_done_) {
+    throw std::logic_error("The stepped search is not done, so there is no move to retrieve.");
+  }
+  stepped_search_running_ = false;
+  stepped_search_done_ = false;
+  return stepped_search_result_;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::UpdateState(Action a) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  for (const pair<Action, Action>& opponent_move_and_reply : pondered_replies_) {
+    if (opponent_move_and_reply.first == a) {
+      has_pondered_reply_ = true;
+      pondered_reply_ = opponent_move_and_reply.second;
+      break;
+    }
+  }
+  pondered_replies_.clear();
+  SetPrincipalVariation(vector<Action>());
+  AI::UpdateState(a);
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::ResetState() {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  SetPrincipalVariation(vector<Action>());
+  AI::ResetState();
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetState(const SuperBoard& state) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  SetPrincipalVariation(vector<Action>());
+  AI::SetState(state);
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::StartPondering() {
+  if (ponder_thread_.joinable() || IsSearching() || stepped_search_running_ || state_.IsComplete()) {
+    return;
+  }
+  stop_requested_ = false;
+  ponder_finished_ = false;
+  pondered_replies_.clear();
+  ponder_thread_ = std::thread(&BasicTreeSearchAI::Ponder, this);
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::StopPondering() {
+  if (ponder_thread_.joinable()) {
+    stop_requested_ = true;
+    ponder_thread_.join();
+    stop_requested_ = false;
+  }
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::IsPondering() const {
+  return ponder_thread_.joinable() && !ponder_finished_;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::HasPonderedReply() const {
+  return has_pondered_reply_;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetSearchDepth(size_t search_depth) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
   search_depth_on_get_move = search_depth;
 }
 
-vector<Action> TreeSearchAI::GetValidActions() const {
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetEndgameSolverThreshold(size_t num_open_cells) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  endgame_solver_threshold_ = num_open_cells;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetProofSearchNodes(size_t max_nodes) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  proof_search_nodes_ = max_nodes;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetEvaluationCacheSize(size_t size_log2) {
+  EvaluationCache evaluation_cache(size_log2);
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  evaluation_cache_ = std::move(evaluation_cache);
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::IsWinOrLossValue(double value) {
+  // Heuristic values are in (-1, 1), and the longest game is still worth more than 1.
+  return std::abs(value) > 1;
+}
+
+template <typename Evaluator>
+size_t BasicTreeSearchAI<Evaluator>::GetPliesToEnd(double value) {
+  return static_cast<size_t>(std::lround((kWinValue - std::abs(value)) / kWinDistanceStep));
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetSelectiveSearch(const SelectiveSearchSettings& settings) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  selective_search_ = settings;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetOpeningBook(const OpeningBook* opening_book) {
+  CancelSearch();
+  StopPondering();
+  AbandonSteppedSearch();
+  has_pondered_reply_ = false;
+  pondered_replies_.clear();
+  opening_book_ = opening_book;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::ProbeOpeningBook(Action& move) {
+  if (opening_book_ == nullptr || !opening_book_->Probe(state_, search_depth_on_get_move, move)) {
+    return false;
+  }
+  BeginSearchStats();
+  EndSearchStats();
+  SetPrincipalVariation(vector<Action>(1, move));
+  return true;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::ProveForcedWin(Action& move) {
+  if (proof_search_nodes_ == 0) {
+    return false;
+  }
+  has_unrecorded_proof_search_ = true;
+  unrecorded_proof_search_start_time_ = std::chrono::steady_clock::now();
+  ProofResult result = proof_number_search_.ProveWin(state_, proof_search_nodes_, move);
+  unrecorded_proof_search_nodes_ = proof_number_search_.GetNodesSearched();
+  if (result != ProofResult::kProven) {
+    return false;
+  }
+  BeginSearchStats();
+  EndSearchStats();
+  SetPrincipalVariation(vector<Action>(1, move));
+  return true;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::TakePonderedReply(Action& move) {
+  if (!has_pondered_reply_) {
+    return false;
+  }
+  has_pondered_reply_ = false;
+  if (has_unrecorded_proof_search_) {
+    has_unrecorded_proof_search_ = false;
+    search_stats_.proof_search_nodes = unrecorded_proof_search_nodes_;
+    search_stats_.elapsed_seconds +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - unrecorded_proof_search_start_time_).count();
+  }
+  move = pondered_reply_;
+  SetPrincipalVariation(vector<Action>(1, move));
+  return true;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::PrepareSelectiveSearch(const BitBoard& board, double alpha, double beta,
+                                                          size_t& depth_to_search, bool& prune_quiet_actions,
+                                                          double& value) {
+  prune_quiet_actions = false;
+  bool uses_futility = depth_to_search <= selective_search_.futility_max_depth;
+  bool uses_razoring = depth_to_search <= selective_search_.razoring_max_depth && depth_to_search > 1;
+  if (!uses_futility && !uses_razoring) {
+    return false;
+  }
+
+  double static_value = EvaluateLeaf(board);
+  if (uses_razoring && static_value + selective_search_.razoring_margin <= alpha) {
+    search_stats_.razorings++;
+    depth_to_search = 1;
+    uses_futility = depth_to_search <= selective_search_.futility_max_depth;
+  }
+  if (uses_futility) {
+    double margin = selective_search_.futility_margin * depth_to_search;
+    if (static_value - margin >= beta) {
+      search_stats_.futility_prunes++;
+      value = static_value - margin;
+      return true;
+    }
+    prune_quiet_actions = (static_value + margin <= alpha);
+  }
+  return false;
+}
+
+template <typename Evaluator>
+size_t BasicTreeSearchAI<Evaluator>::GetLateMoveReduction(size_t depth_to_search, size_t action_index,
+                                                          bool is_quiet) const {
+  if (selective_search_.lmr_min_depth == 0 || depth_to_search < selective_search_.lmr_min_depth ||
+      depth_to_search < 2 || action_index < selective_search_.lmr_first_reduced_action || !is_quiet) {
+    return 0;
+  }
+  return std::min(selective_search_.lmr_reduction, depth_to_search - 2);
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::PlaySearchAction(const Action& a) {
+  evaluator_.PlayMove(state_.GetCurrentPlayer(), BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+  state_.PlayMove(a);
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::ReverseSearchAction() {
+  state_.ReverseAction();
+  evaluator_.ReverseMove();
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::IsQuietAction(const Action& a) const {
+  return !state_.GetState()[a.row_in_board][a.col_in_board].IsComplete();
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::IsQuietAction(const BitBoard& board, const Action& a) {
+  return !(board.GetCompleteSubBoards() & (1 << BitBoard::SubBoardIndex(a)));
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::SolveEndgame(size_t search_ply, pair<Action, double>& action_and_value) {
+  if (endgame_solver_threshold_ == 0) {
+    return false;
+  }
+  return SolveEndgame(BitBoard(state_), search_ply, action_and_value);
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::SolveEndgame(const BitBoard& board, size_t search_ply,
+                                                pair<Action, double>& action_and_value) {
+  if (search_ply <= endgame_solver_failed_ply_) {
+    // Not below the state the solver failed on (if any)
+    endgame_solver_failed_ply_ = kNoEndgameSolverFailure;
+  }
+  if (!ShouldSolveEndgame(board, search_ply)) {
+    return false;
+  }
+  EndgameSolution solution;
+  if (!endgame_solver_.Solve(board, solution)) {
+    search_stats_.endgame_solver_failures++;
+    endgame_solver_failed_ply_ = search_ply;
+    return false;
+  }
+  search_stats_.endgame_solves++;
+  // Proven results have the same values as the end of the game they lead to.
+  action_and_value = {solution.best_move, solution.outcome * GetWinValue(search_ply + solution.distance_to_end)};
+  return true;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::ShouldSolveEndgame(const BitBoard& board, size_t search_ply) const {
+  return endgame_solver_threshold_ != 0 && search_ply <= endgame_solver_failed_ply_ &&
+         board.CountOpenCells() <= endgame_solver_threshold_;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::ClearEndgameSolver() {
+  endgame_solver_.Clear();
+  endgame_solver_failed_ply_ = kNoEndgameSolverFailure;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::Ponder() {
+  BeginSearchStats();
+  ClearEndgameSolver();
+
+  // Order the opponent's moves by how good they look for the opponent, so that the
+  // likeliest moves have their replies ready first. After the opponent's move, the
+  // evaluation is taken with respect to this AI, so lower is better for the opponent.
+  evaluator_.Reset(BitBoard(state_));
+  vector<pair<double, Action>> opponent_moves;
+  for (const Action& a : GetValidActions()) {
+    PlaySearchAction(a);
+    opponent_moves.push_back({evaluator_.Evaluate(BitBoard(state_)), a});
+    ReverseSearchAction();
+  }
+  std::stable_sort(opponent_moves.begin(), opponent_moves.end(),
+                   [](const pair<double, Action>& m1, const pair<double, Action>& m2) { return m1.first < m2.first; });
+
+  // Each reply is a search of its own, which resets the evaluator to the state it starts from.
+  for (const pair<double, Action>& opponent_move : opponent_moves) {
+    state_.PlayMove(opponent_move.second);
+    if (!state_.IsComplete()) {
+      Action reply = EvaluateStateWithSearch(-kWinValue, kWinValue, search_depth_on_get_move).first;
+      if (!stop_requested_) {
+        pondered_replies_.push_back({opponent_move.second, reply});
+      }
+    }
+    state_.ReverseAction();
+    if (stop_requested_) {
+      break;
+    }
+  }
+  EndSearchStats();
+  ponder_finished_ = true;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::BeginSearchStats() {
+  search_stats_.Reset();
+  search_ply_ = 0;
+  search_start_time_ = std::chrono::steady_clock::now();
+  if (has_unrecorded_proof_search_) {
+    // The search is timed from the start of the proof search. The stepped search adds up its time
+    // instead, so it starts from the proof search's time.
+    has_unrecorded_proof_search_ = false;
+    search_stats_.proof_search_nodes = unrecorded_proof_search_nodes_;
+    search_stats_.elapsed_seconds =
+        std::chrono::duration<double>(search_start_time_ - unrecorded_proof_search_start_time_).count();
+    search_start_time_ = unrecorded_proof_search_start_time_;
+  }
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::EndSearchStats() {
+  search_stats_.elapsed_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - search_start_time_).count();
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::LogSearchStats() const {
+  if (search_stats_log_ != nullptr) {
+    *search_stats_log_ << search_stats_;
+  }
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::ResetPrincipalVariation(size_t ply) {
+  if (principal_variations_.size() <= ply + 1) {
+    principal_variations_.resize(ply + 2);
+  }
+  principal_variations_[ply].clear();
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::UpdatePrincipalVariation(const Action& a) {
+  vector<Action>& principal_variation = principal_variations_[search_ply_];
+  const vector<Action>& child_principal_variation = principal_variations_[search_ply_ + 1];
+  principal_variation.assign(1, a);
+  principal_variation.insert(principal_variation.end(), child_principal_variation.begin(),
+                             child_principal_variation.end());
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::SetPrincipalVariation(const vector<Action>& principal_variation) {
+  std::lock_guard<std::mutex> lock(principal_variation_mutex_);
+  principal_variation_ = principal_variation;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::MovePreviousPrincipalVariationActionFirst(vector<Action>& actions) const {
+  if (search_ply_ >= previous_principal_variation_.size()) {
+    return false;
+  }
+  vector<Action>::iterator position = std::find(actions.begin(), actions.end(),
+                                                previous_principal_variation_[search_ply_]);
+  if (position == actions.end()) {
+    return false;
+  }
+  std::rotate(actions.begin(), position, position + 1);
+  return true;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::OrderActionsByDestination(const BitBoard& board, vector<Action>& actions) const {
+  Player player = board.GetCurrentPlayer();
+  Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
+  uint16_t complete_sub_boards = board.GetCompleteSubBoards();
+
+  vector<pair<double, Action>> scored_actions;
+  scored_actions.reserve(actions.size());
+  for (const Action& a : actions) {
+    size_t sub_board = BitBoard::SubBoardIndex(a);
+    size_t destination = BitBoard::CellIndex(a);
+    uint16_t own_marks = board.GetMarks(player, sub_board) | static_cast<uint16_t>(1 << destination);
+    uint16_t opponent_marks = board.GetMarks(opponent, sub_board);
+    bool captures_sub_board = BitBoard::IsWinningMask(own_marks);
+    double score = (captures_sub_board ? kCaptureOrderingValue : 0);
+
+    // The destination's marks are taken after the move, which matters if the move sends the
+    // opponent to the same sub-board.
+    if (destination != sub_board) {
+      own_marks = board.GetMarks(player, destination);
+      opponent_marks = board.GetMarks(opponent, destination);
+    }
+    bool destination_complete = (complete_sub_boards & (1 << destination)) != 0 ||
+                                (destination == sub_board &&
+                                 (captures_sub_board || (own_marks | opponent_marks) == BitBoard::kFullMask));
+    if (destination_complete) {
+      score -= kFreeMoveOrderingCost;
+    } else {
+      if (BitBoard::GetWinningCells(opponent_marks, own_marks) != 0) {
+        score -= kOpponentThreatOrderingCost;
+      }
+      score -= kOwnThreatOrderingCost * PopCount(BitBoard::GetWinningCells(own_marks, opponent_marks));
+    }
+    scored_actions.push_back({score, a});
+  }
+
+  std::stable_sort(scored_actions.begin(), scored_actions.end(),
+                   [](const pair<double, Action>& a1, const pair<double, Action>& a2) { return a1.first > a2.first; });
+  for (size_t i = 0; i < actions.size(); i++) {
+    actions[i] = scored_actions[i].second;
+  }
+}
+
+template <typename Evaluator>
+vector<Action> BasicTreeSearchAI<Evaluator>::GetActionsToSearch(const BitBoard& board, size_t depth_to_search) {
+  // Same order as GetValidActions
+  vector<Action> valid_actions;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    uint16_t valid_cells = board.GetValidCellMask(sub_board);
+    for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+      if (valid_cells & (1 << cell)) {
+        valid_actions.push_back(BitBoard::ToAction(sub_board, cell));
+      }
+    }
+  }
+  // Equivalent actions only have the same value if the evaluator gives equivalent states the same value.
+  uint8_t symmetries = (Evaluator::kIsSymmetric ? board.GetStabilizerSymmetries() : 1);
+  if (symmetries != 1) {
+    // Of each set of equivalent actions, only the first one in the order of GetValidActions is kept.
+    vector<Action> distinct_actions;
+    for (const Action& a : valid_actions) {
+      size_t index = BitBoard::SubBoardIndex(a) * BitBoard::kNumCells + BitBoard::CellIndex(a);
+      bool is_first_equivalent = true;
+      for (size_t symmetry = 1; symmetry < BitBoard::kNumSymmetries && is_first_equivalent; symmetry++) {
+        if (symmetries & (1 << symmetry)) {
+          Action transformed = BitBoard::TransformAction(symmetry, a);
+          is_first_equivalent = (BitBoard::SubBoardIndex(transformed) * BitBoard::kNumCells +
+                                 BitBoard::CellIndex(transformed) >= index);
+        }
+      }
+      if (is_first_equivalent) {
+        distinct_actions.push_back(a);
+      }
+    }
+    search_stats_.symmetric_actions_skipped += valid_actions.size() - distinct_actions.size();
+    valid_actions.swap(distinct_actions);
+  }
+  if (depth_to_search >= 2) {
+    vector<Action> safe_actions;
+    for (const Action& a : valid_actions) {
+      BitBoard child = board;
+      child.PlayMove(BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+      size_t sub_board;
+      size_t cell;
+      if (!child.FindWinningMove(sub_board, cell)) {
+        safe_actions.push_back(a);
+      }
+    }
+    if (!safe_actions.empty()) {
+      search_stats_.unsafe_actions_skipped += valid_actions.size() - safe_actions.size();
+      valid_actions.swap(safe_actions);
+    }
+  }
+  OrderActionsByDestination(board, valid_actions);
+  return valid_actions;
+}
+
+template <typename Evaluator>
+bool BasicTreeSearchAI<Evaluator>::FindImmediateWin(const BitBoard& board, Action& winning_action) {
+  size_t sub_board;
+  size_t cell;
+  if (!board.FindWinningMove(sub_board, cell)) {
+    return false;
+  }
+  search_stats_.immediate_wins++;
+  winning_action = BitBoard::ToAction(sub_board, cell);
+  return true;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::AdvanceSteppedSearch() {
+  SearchFrame& frame = search_stack_.back();
+  if (frame.next_action == frame.valid_actions.size()) {
+    FinishSearchFrame(frame.best_action, frame.alpha);
+    return;
+  }
+
+  // The same steps as the loop body in EvaluateStateWithSearch, except that instead of
+  // recursing, a frame is pushed, and the action's value is applied once it is popped.
+  const Action& a = frame.valid_actions[frame.next_action];
+  PlaySearchAction(a);
+  bool is_quiet = IsQuietAction(a);
+  if (frame.prune_quiet_actions && frame.next_action > 0 && is_quiet) {
+    search_stats_.futility_prunes++;
+    ReverseSearchAction();
+    frame.next_action++;
+    return;
+  }
+  frame.reduction = (frame.researching ? 0 : GetLateMoveReduction(frame.depth_to_search, frame.next_action, is_quiet));
+  if (frame.reduction > 0) {
+    search_stats_.late_move_reductions++;
+  }
+  size_t child_depth = frame.depth_to_search - 1 - frame.reduction;
+  search_stats_.RecordNode(search_stack_.size());
+  ResetPrincipalVariation(search_stack_.size());
+  pair<Action, double> solved_action_and_value;
+  if (state_.IsComplete() || state_.IsDeadDraw()) {
+    search_stats_.terminal_hits++;
+    double value = GetEndOfGameEvaluation(search_stack_.size());
+    ReverseSearchAction();
+    ApplySteppedSearchActionValue(-value);
+  } else if (SolveEndgame(search_stack_.size(), solved_action_and_value)) {
+    principal_variations_[search_stack_.size()].assign(1, solved_action_and_value.first);
+    ReverseSearchAction();
+    ApplySteppedSearchActionValue(-solved_action_and_value.second);
+  } else if (child_depth == 0) {
+    search_stats_.leaf_evaluations++;
+    double value = EvaluateLeaf(BitBoard(state_));
+    ReverseSearchAction();
+    ApplySteppedSearchActionValue(-value);
+  } else {
+    double alpha = max(-frame.beta, -GetWinValue(search_stack_.size() + 2));
+    double beta = std::min(-frame.alpha, GetWinValue(search_stack_.size() + 1));
+    if (alpha >= beta) {
+      // Pruned by mate distance pruning, as in EvaluateStateWithSearch
+      ReverseSearchAction();
+      ApplySteppedSearchActionValue(-alpha);
+      return;
+    }
+    BitBoard board(state_);
+    Action winning_action;
+    if (FindImmediateWin(board, winning_action)) {
+      principal_variations_[search_stack_.size()].assign(1, winning_action);
+      ReverseSearchAction();
+      ApplySteppedSearchActionValue(-GetWinValue(search_stack_.size() + 1));
+      return;
+    }
+    bool prune_quiet_actions = false;
+    double pruned_value;
+    if (PrepareSelectiveSearch(board, alpha, beta, child_depth, prune_quiet_actions, pruned_value)) {
+      ReverseSearchAction();
+      ApplySteppedSearchActionValue(-pruned_value);
+      return;
+    }
+    vector<Action> valid_actions = GetActionsToSearch(board, child_depth);
+    Action first_action = valid_actions[0];
+    SearchFrame child = {alpha, beta, child_depth, std::move(valid_actions), 0, first_action, prune_quiet_actions, 0,
+                         false};
+    search_stack_.push_back(std::move(child));
+  }
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::ApplySteppedSearchActionValue(double action_value) {
+  SearchFrame& frame = search_stack_.back();
+  if (frame.reduction > 0 && action_value > frame.alpha) {
+    // Same as EvaluateStateWithSearch: the action is searched again at full depth.
+    search_stats_.late_move_researches++;
+    frame.researching = true;
+    return;
+  }
+  frame.researching = false;
+  Action a = frame.valid_actions[frame.next_action];
+  if (action_value > frame.alpha) {
+    frame.alpha = action_value;
+    frame.best_action = a;
+    search_ply_ = search_stack_.size() - 1;
+    UpdatePrincipalVariation(a);
+  }
+  if (action_value >= frame.beta) {
+    search_stats_.RecordCutoff(frame.next_action);
+    FinishSearchFrame(a, frame.alpha);
+    return;
+  }
+  frame.next_action++;
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::FinishSearchFrame(Action best_action, double value) {
+  search_stack_.pop_back();
+  if (search_stack_.empty()) {
+    stepped_search_result_ = best_action;
+    stepped_search_done_ = true;
+    SetPrincipalVariation(principal_variations_[0]);
+  } else {
+    ReverseSearchAction();
+    ApplySteppedSearchActionValue(-value);
+  }
+}
+
+template <typename Evaluator>
+void BasicTreeSearchAI<Evaluator>::AbandonSteppedSearch() {
+  while (search_stack_.size() > 1) {
+    search_stack_.pop_back();
+    ReverseSearchAction();
+  }
+  search_stack_.clear();
+  stepped_search_running_ = false;
+  stepped_search_done_ = false;
+}
+
+template <typename Evaluator>
+Action BasicTreeSearchAI<Evaluator>::SearchInBackground() {
+  if (state_.IsComplete()) {
+    throw std::runtime_error("The game state (stored by the AI) is complete, so there are no legal moves to make.");
+  }
+
+  Action move;
+  if (ProbeOpeningBook(move) || ProveForcedWin(move) || TakePonderedReply(move)) {
+    has_pondered_reply_ = false;
+    completed_search_depth_ = search_depth_on_get_move;
+    LogSearchStats();
+    SetBestMoveSoFar(move);
+    return move;
+  }
+
+  BeginSearchStats();
+  ClearEndgameSolver();
+  Action best_action = GetValidActions()[0];
+  SetBestMoveSoFar(best_action);
+  for (size_t depth = 1; depth <= search_depth_on_get_move; depth++) {
+    on_previous_principal_variation_ = true;
+    Action action = EvaluateStateWithSearch(-kWinValue, kWinValue, depth).first;
+    on_previous_principal_variation_ = false;
+    if (stop_requested_) {
+      break;
+    }
+    best_action = action;
+    previous_principal_variation_ = principal_variations_[0];
+    completed_search_depth_ = depth;
+    SetPrincipalVariation(principal_variations_[0]);
+    SetBestMoveSoFar(best_action);
+  }
+  previous_principal_variation_.clear();
+  EndSearchStats();
+  LogSearchStats();
+  return best_action;
+}
+
+template <typename Evaluator>
+vector<Action> BasicTreeSearchAI<Evaluator>::GetValidActions() const {
   vector<Action> valid_actions;
   if (state_.NextRequiredSubBoardExists()) {
     size_t row_in_board = state_.GetNextRequiredSubBoard().x;
@@ -97,7 +1303,8 @@ vector<Action> TreeSearchAI::GetValidActions() const {
   return valid_actions;
 }
 
-vector<vector<double>> TreeSearchAI::ComputeSubBoardWinChanceMetrics(Player player) const {
+template <typename Evaluator>
+vector<vector<double>> BasicTreeSearchAI<Evaluator>::ComputeSubBoardWinChanceMetrics(Player player) const {
   vector<vector<double>> win_chance_metrics(state_.kBoardSize, vector<double>(state_.kBoardSize));
   
   // Search over sub-boards to get a win chance metric for each one
@@ -110,7 +1317,8 @@ vector<vector<double>> TreeSearchAI::ComputeSubBoardWinChanceMetrics(Player play
   return win_chance_metrics;
 }
 
-double TreeSearchAI::ComputeWinChanceMetricInSubBoard(Player player, const SubBoard& sub_board) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::ComputeWinChanceMetricInSubBoard(Player player, const SubBoard& sub_board) const {
   // Search all rows, columns, and diagonals in a sub-board to find the minimum number of moves 
   // along a certain line to win, and convert it to a win chance metric.
   double win_chance_metric = 0;
@@ -132,7 +1340,9 @@ double TreeSearchAI::ComputeWinChanceMetricInSubBoard(Player player, const SubBo
   return win_chance_metric;
 }
 
-double TreeSearchAI::GetWinChanceMetricAlongRow(Player player, const SubBoard& sub_board, size_t row) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::GetWinChanceMetricAlongRow(Player player, const SubBoard& sub_board,
+                                                                size_t row) const {
   Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
   
   // Count represents the number of moves made along the line that's being considered.
@@ -149,7 +1359,9 @@ double TreeSearchAI::GetWinChanceMetricAlongRow(Player player, const SubBoard& s
   return ConvertMoveCountToWinChanceMetric(count);
 }
 
-double TreeSearchAI::GetWinChanceMetricAlongColumn(Player player, const SubBoard& sub_board, size_t col) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::GetWinChanceMetricAlongColumn(Player player, const SubBoard& sub_board,
+                                                                   size_t col) const {
   Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
 
   // Count represents the number of moves made along the line that's being considered.
@@ -166,8 +1378,9 @@ double TreeSearchAI::GetWinChanceMetricAlongColumn(Player player, const SubBoard
   return ConvertMoveCountToWinChanceMetric(count);
 }
 
-double TreeSearchAI::GetWinChanceMetricAlongDiagonal(Player player, const SubBoard& sub_board,
-                                                     bool main_diagonal) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::GetWinChanceMetricAlongDiagonal(Player player, const SubBoard& sub_board,
+                                                                     bool main_diagonal) const {
   Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
 
   // Count represents the number of moves made along the line that's being considered.
@@ -191,7 +1404,8 @@ double TreeSearchAI::GetWinChanceMetricAlongDiagonal(Player player, const SubBoa
   return ConvertMoveCountToWinChanceMetric(count);
 }
 
-double TreeSearchAI::ConvertMoveCountToWinChanceMetric(int count) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::ConvertMoveCountToWinChanceMetric(int count) const {
   if (count == 0) {
     return 0.1;
   } else if (count == 1) {
@@ -205,7 +1419,8 @@ double TreeSearchAI::ConvertMoveCountToWinChanceMetric(int count) const {
   }
 }
 
-vector<vector<double>> TreeSearchAI::ComputePossibleWinLineCounts(Player player) const {
+template <typename Evaluator>
+vector<vector<double>> BasicTreeSearchAI<Evaluator>::ComputePossibleWinLineCounts(Player player) const {
   Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
   vector<vector<double>> possible_win_line_counts(state_.kBoardSize, vector<double>(state_.kBoardSize));
   
@@ -271,7 +1486,9 @@ vector<vector<double>> TreeSearchAI::ComputePossibleWinLineCounts(Player player)
   return possible_win_line_counts;
 }
 
-double TreeSearchAI::TwoDimVectorDotProduct(const vector<vector<double>>& v1, const vector<vector<double>>& v2) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::TwoDimVectorDotProduct(const vector<vector<double>>& v1,
+                                                            const vector<vector<double>>& v2) const {
   double result = 0;
   for (size_t i = 0; i < v1.size(); i++) {
     for (size_t j = 0; j < v1[i].size(); j++) {
@@ -281,30 +1498,71 @@ double TreeSearchAI::TwoDimVectorDotProduct(const vector<vector<double>>& v1, co
   return result;
 }
 
-double TreeSearchAI::GetEndOfGameEvaluation() const {
-  // It might not be possible for this function to return 1, actually,
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::GetEndOfGameEvaluation(size_t search_ply) const {
+  // It might not be possible for this function to return a win, actually,
   // since as soon as a player wins, their opponent becomes the active player
   // and it is no longer possible to make moves, so the winner will never
   // become the active player.
   if (state_.GetWinner() == WinState::kPlayer1Win) {
     if (state_.GetCurrentPlayer() == Player::kPlayer1) {
-      return 1;
+      return GetWinValue(search_ply);
     } else {
-      return -1;
+      return -GetWinValue(search_ply);
     }
   } else if (state_.GetWinner() == WinState::kPlayer2Win) {
     if (state_.GetCurrentPlayer() == Player::kPlayer2) {
-      return 1;
+      return GetWinValue(search_ply);
     } else {
-      return -1;
+      return -GetWinValue(search_ply);
     }
   } else {
     return 0;
   }
 }
 
-double TreeSearchAI::RescaleEvaluation(double evaluation_score) const {
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::GetEndOfGameEvaluation(const BitBoard& board, size_t search_ply) {
+  WinState winner = board.GetWinner();
+  if (winner != WinState::kPlayer1Win && winner != WinState::kPlayer2Win) {
+    return 0;
+  }
+  bool current_player_won = (winner == WinState::kPlayer1Win) == (board.GetCurrentPlayer() == Player::kPlayer1);
+  return current_player_won ? GetWinValue(search_ply) : -GetWinValue(search_ply);
+}
+
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::GetWinValue(size_t search_ply) {
+  return kWinValue - static_cast<double>(search_ply) * kWinDistanceStep;
+}
+
+template <typename Evaluator>
+double BasicTreeSearchAI<Evaluator>::RescaleEvaluation(double evaluation_score) const {
   return tanh(evaluation_score * kRescalingFactor);
 }
 
+// The evaluators that TreeSearchAIs are compiled with. Each one that MakeTreeSearchAI can make
+// must be instantiated here.
+template class BasicTreeSearchAI<HeuristicEvaluator>;
+template class BasicTreeSearchAI<NeuralEvaluator>;
+template class BasicTreeSearchAI<PatternEvaluator>;
+
+std::unique_ptr<SearchAI> MakeTreeSearchAI(EvaluatorType evaluator_type, const string& weights_path) {
+  switch (evaluator_type) {
+    case EvaluatorType::kHeuristic:
+      return std::unique_ptr<SearchAI>(new BasicTreeSearchAI<HeuristicEvaluator>());
+    case EvaluatorType::kNeural: {
+      std::unique_ptr<BasicTreeSearchAI<NeuralEvaluator>> ai(new BasicTreeSearchAI<NeuralEvaluator>());
+      ai->GetEvaluator().Load(weights_path);
+      return std::unique_ptr<SearchAI>(ai.release());
+    }
+    case EvaluatorType::kPattern: {
+      std::unique_ptr<BasicTreeSearchAI<PatternEvaluator>> ai(new BasicTreeSearchAI<PatternEvaluator>());
+      ai->GetEvaluator().Load(weights_path);
+      return std::unique_ptr<SearchAI>(ai.release());
+    }
+  }
+  throw std::invalid_argument("Unknown evaluator type.");
+}
+
 }  // namespace ultimate_tictactoe
@@ -0,0 +1,33 @@
+#include <visualizer/analysis_toggle_button.h>
+
+namespace ultimate_tictactoe {
+
+namespace visualizer {
+
+AnalysisToggleButton::AnalysisToggleButton(vec2 kTopLeft, vec2 kBottomRight, ci::Color kButtonColor,
+                                           ci::Color kButtonColorDark)
+    : Button(kTopLeft, kBottomRight, kButtonColor, kButtonColorDark) {}
+
+void AnalysisToggleButton::DrawAnalysisToggleButtonAndText(const vec2& mouse_pos, AnalysisMode analysis_mode) const {
+  ci::gl::drawStringCentered(kButtonTitle, (kTopLeft + kBottomRight) / 2.0f + vec2(0, kTitleOffset), kFontColor, kFont);
+
+  if (MouseIsOnButton(mouse_pos)) {
+    ci::gl::color(kColorDark);
+  } else {
+    ci::gl::color(kColor);
+  }
+  ci::gl::drawSolidRect(ci::Rectf(kTopLeft.x, kTopLeft.y, kBottomRight.x, kBottomRight.y));
+  string text;
+  if (analysis_mode == AnalysisMode::kOff) {
+    text = "Off";
+  } else if (analysis_mode == AnalysisMode::kLines) {
+    text = "On";
+  } else {
+    text = "Heatmap";
+  }
+  ci::gl::drawStringCentered(text, (kTopLeft + kBottomRight) / 2.0f - vec2(0, kFont.getSize() / 3), kFontColor, kFont);
+}
+
+}  // namespace visualizer
+
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,51 @@
+#include <iomanip>
+#include <sstream>
+
+#include <visualizer/analysis_view.h>
+
+namespace ultimate_tictactoe {
+
+namespace visualizer {
+
+void AnalysisView::DrawAnalysis(const SuperBoard& board_, const AnalysisInfo& analysis, size_t position_id) const {
+  if (analysis.depth == 0 || analysis.position_id != position_id) {
+    ci::gl::drawString("Analyzing...", kAnalysisTopLeft, kFontColor, kFont);
+    return;
+  }
+
+  std::ostringstream header;
+  header << "Depth " << analysis.depth << ", " << static_cast<size_t>(analysis.nodes_per_second / 1000)
+         << "k nodes/s";
+  if (analysis.forced_win == ProofResult::kProven) {
+    header << ", forced win: " << ActionToString(analysis.forced_win_move);
+  }
+  ci::gl::drawString(header.str(), kAnalysisTopLeft, kFontColor, kFont);
+
+  // Values are for the player to move, so they are flipped when Player 2 is to move.
+  double sign = (board_.GetCurrentPlayer() == Player::kPlayer1 ? 1 : -1);
+  for (size_t i = 0; i < analysis.lines.size() && i < kMaxLinesShown; i++) {
+    const AnalysisLine& line = analysis.lines[i];
+    std::ostringstream row;
+    if (TreeSearchAI::IsWinOrLossValue(line.value)) {
+      // Won and lost games are shown as the number of plies to the end, e.g. +#3
+      row << (sign * line.value > 0 ? "+#" : "-#") << TreeSearchAI::GetPliesToEnd(line.value);
+    } else {
+      row << std::fixed << std::setprecision(2) << std::showpos << sign * line.value << std::noshowpos;
+    }
+    for (size_t j = 0; j < line.principal_variation.size() && j < kMaxMovesShownPerLine; j++) {
+      row << "  " << ActionToString(line.principal_variation[j]);
+    }
+    ci::gl::drawString(row.str(), kAnalysisTopLeft + vec2(0, kRowHeight * (i + 1)), kFontColor, kFont);
+  }
+}
+
+string AnalysisView::ActionToString(const Action& a) const {
+  std::ostringstream text;
+  text << a.row_in_board * SuperBoard::kBoardSize + a.col_in_board + 1 << "/"
+       << a.row_in_subboard * SuperBoard::kBoardSize + a.col_in_subboard + 1;
+  return text.str();
+}
+
+}  // namespace visualizer
+
+}  // namespace ultimate_tictactoe
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "cinder/gl/gl.h"
 #include <core/action.h>
 #include <core/mark.h>
@@ -9,9 +11,11 @@ namespace ultimate_tictactoe {
 
 namespace visualizer {
 
-void BoardView::DrawSuperBoard(const SuperBoard& board_, const vec2& mouse_pos, CompletionStage completion_stage_, bool current_player_is_human) const {
+void BoardView::DrawSuperBoard(const SuperBoard& board_, const vec2& mouse_pos, CompletionStage completion_stage_, bool current_player_is_human,
+                               const vector<AnalysisLine>& move_scores) const {
   if (completion_stage_ == CompletionStage::kInGame) {
     DrawAvailableSubBoardIndicator(board_);
+    DrawMoveScores(move_scores);
     DrawHover(board_, mouse_pos, current_player_is_human);
   }
   
@@ -71,6 +75,10 @@ void BoardView::DrawSubBoardMarks(size_t row_in_super_board, size_t col_in_super
 }
 
 void BoardView::DrawAvailableSubBoardIndicator(const SuperBoard& board_) const {
+  if (board_.IsDeadDraw()) {
+    // The game ended early, so no sub-board is available.
+    return;
+  }
   if (board_.NextRequiredSubBoardExists()) {
     ivec2 next_required_sub_board = board_.GetNextRequiredSubBoard();
     DrawSubBoardBackground(next_required_sub_board.x, next_required_sub_board.y, kSubBoardAvailableColor);
@@ -85,6 +93,29 @@ void BoardView::DrawAvailableSubBoardIndicator(const SuperBoard& board_) const {
   }
 }
 
+void BoardView::DrawMoveScores(const vector<AnalysisLine>& move_scores) const {
+  if (move_scores.empty()) {
+    return;
+  }
+
+  double min_value = move_scores[0].value;
+  double max_value = move_scores[0].value;
+  for (const AnalysisLine& line : move_scores) {
+    min_value = std::min(min_value, line.value);
+    max_value = std::max(max_value, line.value);
+  }
+
+  for (const AnalysisLine& line : move_scores) {
+    // If every move has the same value, they are all shown halfway between the colors.
+    float fraction_of_range = 0.5f;
+    if (max_value > min_value) {
+      fraction_of_range = static_cast<float>((line.value - min_value) / (max_value - min_value));
+    }
+    ci::gl::color(ci::lerp(kHeatmapWorstColor, kHeatmapBestColor, fraction_of_range));
+    ci::gl::drawSolidRect(GetCellRect(line.action, kHeatmapCellMargin));
+  }
+}
+
 void BoardView::DrawGrid(const vec2& top_left, const vec2& bottom_right, float line_width,
                                     const ci::Color& color) const {
   ci::gl::color(color);
@@ -104,20 +135,20 @@ void BoardView::DrawGrid(const vec2& top_left, const vec2& bottom_right, float l
 }
 
 void BoardView::DrawMark(const Action& a, const ci::Color& color) const {
+  ci::gl::color(color);
+  ci::gl::drawSolidRoundedRect(GetCellRect(a, kMarkMargin), kMarkCornerRadius);
+}
+
+ci::Rectf BoardView::GetCellRect(const Action& a, float margin) const {
   const vec2 kSubBoardTopLeft = GetSubBoardTopLeft(a.row_in_board, a.col_in_board);
   const float kSubBoardLengthWithoutMargin = kSubBoardLength - 2 * kSubBoardMargin;
-  ci::gl::color(color);
-  ci::gl::drawSolidRoundedRect(
-      ci::Rectf(
-          kSubBoardTopLeft.x + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.col_in_subboard / kBoardSize +
-              kMarkMargin,
-          kSubBoardTopLeft.y + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.row_in_subboard / kBoardSize +
-              kMarkMargin,
-          kSubBoardTopLeft.x + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.col_in_subboard / kBoardSize +
-              kSubBoardLengthWithoutMargin / kBoardSize - kMarkMargin,
-          kSubBoardTopLeft.y + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.row_in_subboard / kBoardSize +
-              kSubBoardLengthWithoutMargin / kBoardSize - kMarkMargin),
-      kMarkCornerRadius);
+  return ci::Rectf(
+      kSubBoardTopLeft.x + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.col_in_subboard / kBoardSize + margin,
+      kSubBoardTopLeft.y + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.row_in_subboard / kBoardSize + margin,
+      kSubBoardTopLeft.x + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.col_in_subboard / kBoardSize +
+          kSubBoardLengthWithoutMargin / kBoardSize - margin,
+      kSubBoardTopLeft.y + kSubBoardMargin + kSubBoardLengthWithoutMargin * a.row_in_subboard / kBoardSize +
+          kSubBoardLengthWithoutMargin / kBoardSize - margin);
 }
 
 void BoardView::DrawHover(const SuperBoard& board_, const vec2& mouse_pos, bool current_player_is_human) const {
@@ -34,6 +34,10 @@ void GameCompletionMessageView::SetMessageParameters(string& top_text, string& b
     top_text = "Tie";
     bottom_text = "1/2 - 1/2";
     color = kMessageTieColor;
+  } else if (board_.IsDeadDraw()) {
+    top_text = "Tie (no wins left)";
+    bottom_text = "1/2 - 1/2";
+    color = kMessageTieColor;
   } else {
     top_text = "Player 2 wins";
     bottom_text = "0 - 1";
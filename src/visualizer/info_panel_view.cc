@@ -11,11 +11,15 @@ InfoPanelView::InfoPanelView() : P1_AI_toggle_button_(kP1AIToggleButtonTopLeft,
                                  P2_AI_toggle_button_(kP2AIToggleButtonTopLeft, kP2AIToggleButtonBottomRight,
                                                       kP2AIToggleButtonColor, kP2AIToggleButtonColorDark,
                                                       kP2AIToggleButtonTitle),
+                                 analysis_toggle_button_(kAnalysisToggleButtonTopLeft,
+                                                         kAnalysisToggleButtonBottomRight, kAnalysisToggleButtonColor,
+                                                         kAnalysisToggleButtonColorDark),
                                  start_or_reset_button_(kStartOrResetButtonTopLeft, kStartOrResetButtonBottomRight,
                                                         kStartOrResetButtonColor, kStartOrResetButtonColorDark) {}
 
 void InfoPanelView::DrawInfoPanel(const SuperBoard& board_, const vec2& mouse_pos,
-                                  const CompletionStage& completion_stage_, bool p1_is_AI, bool p2_is_AI) {
+                                  const CompletionStage& completion_stage_, bool p1_is_AI, bool p2_is_AI,
+                                  AnalysisMode analysis_mode, const AnalysisInfo& analysis, size_t position_id) {
   ci::gl::color(kInfoPanelColor);
   ci::gl::drawSolidRect(
       ci::Rectf(kInfoPanelTopLeft.x, kInfoPanelTopLeft.y, kInfoPanelBottomRight.x, kInfoPanelBottomRight.y));
@@ -24,6 +28,12 @@ void InfoPanelView::DrawInfoPanel(const SuperBoard& board_, const vec2& mouse_po
   if (completion_stage_ == CompletionStage::kPreGame) {
     P1_AI_toggle_button_.DrawAIToggleButtonAndText(mouse_pos, p1_is_AI);
     P2_AI_toggle_button_.DrawAIToggleButtonAndText(mouse_pos, p2_is_AI);
+#ifndef SINGLE_THREADED_AI
+    analysis_toggle_button_.DrawAnalysisToggleButtonAndText(mouse_pos, analysis_mode);
+#endif
+  }
+  if (completion_stage_ == CompletionStage::kInGame && analysis_mode != AnalysisMode::kOff) {
+    analysis_view_.DrawAnalysis(board_, analysis, position_id);
   }
   if (completion_stage_ == CompletionStage::kPostGame) {
     game_completion_message_view_.DrawGameCompletionMessage(board_);
@@ -42,6 +52,10 @@ bool InfoPanelView::MouseIsOnP2AIToggleButton(const vec2& mouse_pos) {
   return P2_AI_toggle_button_.MouseIsOnButton(mouse_pos);
 }
 
+bool InfoPanelView::MouseIsOnAnalysisToggleButton(const vec2& mouse_pos) {
+  return analysis_toggle_button_.MouseIsOnButton(mouse_pos);
+}
+
 }  // namespace visualizer
 
 }  // namespace ultimate_tictactoe
\ No newline at end of file
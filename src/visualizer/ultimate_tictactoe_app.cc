@@ -1,3 +1,5 @@
+#include <stdexcept>
+
 #include "cinder/gl/gl.h"
 #include <visualizer/ultimate_tictactoe_app.h>
 #include <core/board.h>
@@ -9,26 +11,66 @@ namespace visualizer {
   
 using cinder::ivec2;
 
-UltimateTicTacToeApp::UltimateTicTacToeApp() : completion_stage_(CompletionStage::kPreGame),
-                                               p1_is_AI_(false), p2_is_AI_(false) {
+UltimateTicTacToeApp::UltimateTicTacToeApp() : analysis_(), analysis_position_id_(0), completion_stage_(CompletionStage::kPreGame),
+                                               p1_is_AI_(false), p2_is_AI_(false), analysis_mode_(AnalysisMode::kOff) {
   ci::app::setWindowSize(ivec2(kWindowSize));
+  try {
+    p1_AI_ = MakeTreeSearchAI(kAIEvaluator, kEvaluatorWeightsPath);
+    p2_AI_ = MakeTreeSearchAI(kAIEvaluator, kEvaluatorWeightsPath);
+  } catch (const std::runtime_error&) {
+    p1_AI_ = MakeTreeSearchAI(EvaluatorType::kHeuristic);
+    p2_AI_ = MakeTreeSearchAI(EvaluatorType::kHeuristic);
+  }
+  p1_AI_->SetEndgameSolverThreshold(TreeSearchAI::kSuggestedEndgameSolverThreshold);
+  p2_AI_->SetEndgameSolverThreshold(TreeSearchAI::kSuggestedEndgameSolverThreshold);
+  p1_AI_->SetProofSearchNodes(TreeSearchAI::kSuggestedProofSearchNodes);
+  p2_AI_->SetProofSearchNodes(TreeSearchAI::kSuggestedProofSearchNodes);
+  p1_AI_->SetSelectiveSearch(SelectiveSearchSettings::Suggested());
+  p2_AI_->SetSelectiveSearch(SelectiveSearchSettings::Suggested());
+  try {
+    opening_book_.Open(kOpeningBookPath);
+    p1_AI_->SetOpeningBook(&opening_book_);
+    p2_AI_->SetOpeningBook(&opening_book_);
+  } catch (const std::runtime_error&) {
+    // Without a book, the AIs search every move.
+  }
   ResetGameAndAIBoards();
 }
 
 void UltimateTicTacToeApp::draw() {
   ci::Color8u background_color(ci::Color::gray(0.9));
   ci::gl::clear(background_color);
-  board_view_.DrawSuperBoard(board_, getMousePos(), completion_stage_, CurrentPlayerIsHuman());
-  info_panel_view_.DrawInfoPanel(board_, getMousePos(), completion_stage_, p1_is_AI_, p2_is_AI_);
+  // The heatmap only shows the latest analysis once it is of the displayed board.
+  const vector<AnalysisLine> no_move_scores;
+  bool show_heatmap = (analysis_mode_ == AnalysisMode::kHeatmap && analysis_.position_id == analysis_position_id_);
+  board_view_.DrawSuperBoard(board_, getMousePos(), completion_stage_, CurrentPlayerIsHuman(),
+                             show_heatmap ? analysis_.lines : no_move_scores);
+  info_panel_view_.DrawInfoPanel(board_, getMousePos(), completion_stage_, p1_is_AI_, p2_is_AI_, analysis_mode_,
+                                 analysis_, analysis_position_id_);
 }
 
 void UltimateTicTacToeApp::update() {
+  if (analysis_engine_.IsRunning()) {
+    analysis_engine_.PollAnalysis(analysis_);
+  }
+
   if (completion_stage_ == CompletionStage::kInGame) {
     if (board_.GetCurrentPlayer() == Player::kPlayer1 && p1_is_AI_) {
-      UpdateGameAndAIBoards(p1_AI_.GetMove());
+      UpdateAISearch(*p1_AI_);
     } else if (board_.GetCurrentPlayer() == Player::kPlayer2 && p2_is_AI_) {
-      UpdateGameAndAIBoards(p2_AI_.GetMove());
+      UpdateAISearch(*p2_AI_);
     }
+#ifndef SINGLE_THREADED_AI
+    else {
+      // A human is thinking, so the AI (if any) can ponder its replies in the meantime.
+      if (p1_is_AI_) {
+        p1_AI_->StartPondering();
+      }
+      if (p2_is_AI_) {
+        p2_AI_->StartPondering();
+      }
+    }
+#endif
   }
 }
 
@@ -36,22 +78,44 @@ void UltimateTicTacToeApp::mouseDown(cinder::app::MouseEvent event) {
   HandleBoardClick(event);
   HandleStartOrResetGameButtonClick(event);
   HandleAIToggleButtonClick(event);
+  HandleAnalysisToggleButtonClick(event);
 }
 
 void UltimateTicTacToeApp::UpdateGameAndAIBoards(const Action &a) {
   board_.PlayMove(a);
-  p1_AI_.UpdateState(a);
-  p2_AI_.UpdateState(a);
+  p1_AI_->UpdateState(a);
+  p2_AI_->UpdateState(a);
+  if (analysis_engine_.IsRunning()) {
+    analysis_position_id_ = analysis_engine_.SetPosition(board_);
+  }
 
-  if (board_.IsComplete()) {
+  // Dead draws end the game early, since it can only end in a tie.
+  if (board_.IsComplete() || board_.IsDeadDraw()) {
     completion_stage_ = CompletionStage::kPostGame;
   }
 }
 
+void UltimateTicTacToeApp::UpdateAISearch(SearchAI& ai) {
+#ifdef SINGLE_THREADED_AI
+  if (!ai.IsSteppedSearchRunning()) {
+    ai.BeginSteppedSearch();
+  }
+  if (ai.StepSearch(kAISearchTimeSlice)) {
+    UpdateGameAndAIBoards(ai.FinishSteppedSearch());
+  }
+#else
+  if (!ai.IsSearching()) {
+    ai.StartSearch();
+  } else if (ai.IsSearchDone()) {
+    UpdateGameAndAIBoards(ai.FinishSearch());
+  }
+#endif
+}
+
 void UltimateTicTacToeApp::ResetGameAndAIBoards() {
   board_ = SuperBoard();
-  p1_AI_.ResetState();
-  p2_AI_.ResetState();
+  p1_AI_->ResetState();
+  p2_AI_->ResetState();
 }
 
 void UltimateTicTacToeApp::HandleBoardClick(cinder::app::MouseEvent event) {
@@ -76,12 +140,40 @@ void UltimateTicTacToeApp::HandleAIToggleButtonClick(cinder::app::MouseEvent eve
   }
 }
 
+void UltimateTicTacToeApp::HandleAnalysisToggleButtonClick(cinder::app::MouseEvent event) {
+#ifdef SINGLE_THREADED_AI
+  // The analysis engine searches on a background thread, so analysis stays off.
+  (void)event;
+#else
+  if (completion_stage_ == CompletionStage::kPreGame) {
+    if (info_panel_view_.MouseIsOnAnalysisToggleButton(event.getPos())) {
+      // Cycles through the modes in the order they are declared.
+      if (analysis_mode_ == AnalysisMode::kOff) {
+        analysis_mode_ = AnalysisMode::kLines;
+      } else if (analysis_mode_ == AnalysisMode::kLines) {
+        analysis_mode_ = AnalysisMode::kHeatmap;
+      } else {
+        analysis_mode_ = AnalysisMode::kOff;
+      }
+    }
+  }
+#endif
+}
+
 void UltimateTicTacToeApp::HandleStartOrResetGameButtonClick(cinder::app::MouseEvent event) {
   if (info_panel_view_.MouseIsOnStartOrResetGameButton(event.getPos())) {
     if (completion_stage_ == CompletionStage::kPreGame) {
       completion_stage_ = CompletionStage::kInGame;
+      if (analysis_mode_ != AnalysisMode::kOff) {
+        // The heatmap needs a value for every valid move, not just the best few.
+        analysis_engine_.SetNumLines(analysis_mode_ == AnalysisMode::kHeatmap ? AnalysisEngine::kAllLines
+                                                                               : kNumAnalysisLines);
+        analysis_engine_.Start();
+        analysis_position_id_ = analysis_engine_.SetPosition(board_);
+      }
     } else {
       completion_stage_ = CompletionStage::kPreGame;
+      analysis_engine_.Stop();
       ResetGameAndAIBoards();
     }
   }
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <core/analysis_engine.h>
+#include <core/bitboard.h>
+#include <core/proof_number_search.h>
+#include <core/tree_search_ai.h>
+
+using ultimate_tictactoe::AnalysisEngine;
+using ultimate_tictactoe::AnalysisInfo;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::ProofNumberSearch;
+using ultimate_tictactoe::ProofResult;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+
+namespace {
+
+// Polls the engine until it publishes an analysis of at least the given depth, or a few seconds pass.
+bool WaitForAnalysis(AnalysisEngine& engine, AnalysisInfo& analysis, size_t min_depth) {
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (engine.PollAnalysis(analysis) && analysis.depth >= min_depth) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST_CASE("Testing AnalysisEngine") {
+  SuperBoard board;
+  board.PlayMove({1, 2, 0, 2});
+  board.PlayMove({0, 2, 1, 2});
+
+  SECTION("Analysis matches the multi-PV search") {
+    AnalysisEngine engine(2);
+    size_t position_id = engine.SetPosition(board);
+    engine.Start();
+    AnalysisInfo analysis;
+    REQUIRE(WaitForAnalysis(engine, analysis, 2));
+    engine.Stop();
+    REQUIRE_FALSE(engine.IsRunning());
+
+    REQUIRE(analysis.position_id == position_id);
+    REQUIRE(analysis.lines.size() == 2);
+    REQUIRE(analysis.nodes > 0);
+
+    TreeSearchAI AI;
+    AI.SetState(board);
+    ultimate_tictactoe::AnalysisLine expected_line = AI.EvaluateTopActions(2, analysis.depth)[0];
+    REQUIRE(analysis.lines[0].action == expected_line.action);
+    REQUIRE(analysis.lines[0].value == Approx(expected_line.value));
+    REQUIRE(analysis.lines[0].principal_variation == expected_line.principal_variation);
+  }
+
+  SECTION("Analysis restarts when the position changes") {
+    AnalysisEngine engine(1);
+    engine.Start();
+    engine.SetPosition(SuperBoard());
+    AnalysisInfo analysis;
+    REQUIRE(WaitForAnalysis(engine, analysis, 1));
+
+    size_t position_id = engine.SetPosition(board);
+    REQUIRE(WaitForAnalysis(engine, analysis, 1));
+    REQUIRE(analysis.position_id == position_id);
+    REQUIRE(board.IsValidMove(analysis.lines[0].action));
+  }
+
+  SECTION("Every move is analyzed with kAllLines") {
+    AnalysisEngine engine;
+    engine.SetNumLines(AnalysisEngine::kAllLines);
+    engine.SetPosition(board);
+    engine.Start();
+    AnalysisInfo analysis;
+    REQUIRE(WaitForAnalysis(engine, analysis, 1));
+    REQUIRE(analysis.lines.size() == BitBoard(board).CountValidMoves());
+    for (const ultimate_tictactoe::AnalysisLine& line : analysis.lines) {
+      REQUIRE(board.IsValidMove(line.action));
+    }
+  }
+
+  SECTION("Cached analysis is reported when returning to a position") {
+    AnalysisEngine engine(1);
+    engine.Start();
+    engine.SetPosition(board);
+    AnalysisInfo analysis;
+    REQUIRE(WaitForAnalysis(engine, analysis, 2));
+    size_t cached_depth = analysis.depth;
+
+    engine.SetPosition(SuperBoard());
+    REQUIRE(WaitForAnalysis(engine, analysis, 1));
+
+    size_t position_id = engine.SetPosition(board);
+    REQUIRE(engine.PollAnalysis(analysis));
+    REQUIRE(analysis.position_id == position_id);
+    REQUIRE(analysis.depth >= cached_depth);
+
+    // The cached analysis has too few lines once more lines are wanted. The engine is stopped
+    // so that it cannot publish a new analysis in the meantime.
+    engine.Stop();
+    engine.SetNumLines(2);
+    engine.SetPosition(board);
+    REQUIRE_FALSE(engine.PollAnalysis(analysis));
+  }
+
+  SECTION("Forced wins are reported") {
+    // Plays the first valid move until the player to move can be proven to force a win. The
+    // table is cleared before each search, so that the proof is the same as the engine's.
+    SuperBoard won_board = board;
+    ultimate_tictactoe::Action proof_move = {0, 0, 0, 0};
+    ProofNumberSearch search;
+    while (search.ProveWin(won_board, AnalysisEngine::kProofSearchNodesPerDepth, proof_move) != ProofResult::kProven) {
+      search.Clear();
+      BitBoard bit_board(won_board);
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        if (bit_board.GetValidCellMask(sub_board) != 0) {
+          size_t cell = ultimate_tictactoe::SelectNthSetBit(bit_board.GetValidCellMask(sub_board), 0);
+          won_board.PlayMove(BitBoard::ToAction(sub_board, cell));
+          break;
+        }
+      }
+      REQUIRE_FALSE(won_board.IsComplete());
+    }
+
+    AnalysisEngine engine(1);
+    engine.SetPosition(won_board);
+    engine.Start();
+    AnalysisInfo analysis;
+    REQUIRE(WaitForAnalysis(engine, analysis, 1));
+    REQUIRE(analysis.forced_win == ProofResult::kProven);
+    REQUIRE(analysis.forced_win_move == proof_move);
+
+    engine.SetPosition(SuperBoard());
+    REQUIRE(WaitForAnalysis(engine, analysis, 1));
+    REQUIRE(analysis.forced_win == ProofResult::kUnknown);
+  }
+}
@@ -0,0 +1,67 @@
+#include <cmath>
+
+#include <catch2/catch.hpp>
+#include <core/batch_playout.h>
+#include <core/random_playout.h>
+#include <core/superboard.h>
+
+using ultimate_tictactoe::BatchPlayout;
+using ultimate_tictactoe::PlayoutCounts;
+using ultimate_tictactoe::RandomPlayout;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::WinState;
+
+TEST_CASE("Testing BatchPlayout's Play method") {
+  SECTION("Counts sum to the number of playouts, including partial batches") {
+    BatchPlayout batch_playout;
+    PlayoutCounts counts = batch_playout.Play(SuperBoard(), 100);
+    REQUIRE(counts.wins + counts.draws + counts.losses == 100);
+  }
+
+  SECTION("Playouts from a complete game all return its result") {
+    SuperBoard board;
+    board.PlayMove({1, 2, 0, 2});
+    board.PlayMove({0, 2, 1, 2});
+    board.PlayMove({1, 2, 2, 2});
+    board.PlayMove({2, 2, 1, 2});
+    board.PlayMove({1, 2, 1, 2});
+    board.PlayMove({0, 0, 1, 1});
+    board.PlayMove({1, 1, 1, 0});
+    board.PlayMove({1, 0, 1, 1});
+    board.PlayMove({1, 1, 1, 2});
+    board.PlayMove({2, 0, 1, 1});
+    board.PlayMove({1, 1, 1, 1});
+    board.PlayMove({2, 1, 1, 0});
+    board.PlayMove({1, 0, 0, 0});
+    board.PlayMove({0, 0, 1, 0});
+    board.PlayMove({1, 0, 0, 1});
+    board.PlayMove({0, 1, 1, 0});
+    board.PlayMove({1, 0, 0, 2});
+
+    // Player 1 has won, and it is Player 2's turn.
+    BatchPlayout batch_playout;
+    PlayoutCounts counts = batch_playout.Play(board, 64);
+    REQUIRE(counts.losses == 64);
+  }
+
+  SECTION("Outcome frequencies match the scalar playout kernel") {
+    const size_t kNumPlayouts = 64 * 200;
+    BatchPlayout batch_playout;
+    PlayoutCounts counts = batch_playout.Play(SuperBoard(), kNumPlayouts);
+
+    RandomPlayout playout;
+    size_t scalar_counts[4] = {0};
+    for (size_t i = 0; i < kNumPlayouts; i++) {
+      scalar_counts[static_cast<size_t>(playout.Play(SuperBoard()))]++;
+    }
+
+    // Player 1 is to move, so Player 1 wins are counted as wins.
+    const double kTolerance = 0.03;
+    REQUIRE(std::abs(static_cast<double>(counts.wins) - scalar_counts[static_cast<size_t>(WinState::kPlayer1Win)]) /
+            kNumPlayouts < kTolerance);
+    REQUIRE(std::abs(static_cast<double>(counts.losses) - scalar_counts[static_cast<size_t>(WinState::kPlayer2Win)]) /
+            kNumPlayouts < kTolerance);
+    REQUIRE(std::abs(static_cast<double>(counts.draws) - scalar_counts[static_cast<size_t>(WinState::kTie)]) /
+            kNumPlayouts < kTolerance);
+  }
+}
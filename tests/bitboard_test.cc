@@ -0,0 +1,283 @@
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/random_playout.h>
+#include <core/superboard.h>
+
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::Player;
+using ultimate_tictactoe::WinState;
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::XorShiftRandom;
+
+TEST_CASE("Testing BitBoard's bit helper functions") {
+  SECTION("PopCount") {
+    REQUIRE(ultimate_tictactoe::PopCount(0) == 0);
+    REQUIRE(ultimate_tictactoe::PopCount(0x1FF) == 9);
+    REQUIRE(ultimate_tictactoe::PopCount(0x111) == 3);
+  }
+
+  SECTION("SelectNthSetBit") {
+    REQUIRE(ultimate_tictactoe::SelectNthSetBit(0x111, 0) == 0);
+    REQUIRE(ultimate_tictactoe::SelectNthSetBit(0x111, 1) == 4);
+    REQUIRE(ultimate_tictactoe::SelectNthSetBit(0x111, 2) == 8);
+  }
+
+  SECTION("IsWinningMask") {
+    REQUIRE(BitBoard::IsWinningMask(0007));
+    REQUIRE(BitBoard::IsWinningMask(0421));
+    REQUIRE(BitBoard::IsWinningMask(0124));
+    REQUIRE_FALSE(BitBoard::IsWinningMask(0));
+    REQUIRE_FALSE(BitBoard::IsWinningMask(0013));
+  }
+
+  SECTION("GetWinningCells") {
+    REQUIRE(BitBoard::GetWinningCells(0003, 0) == 0004);
+    REQUIRE(BitBoard::GetWinningCells(0003, 0004) == 0);
+    REQUIRE(BitBoard::GetWinningCells(0021, 0) == 0400);
+    REQUIRE(BitBoard::GetWinningCells(0, 0) == 0);
+
+    // Every pair of masks matches a brute-force check of the empty cells
+    for (uint16_t marks = 0; marks <= BitBoard::kFullMask; marks++) {
+      for (uint16_t other_marks = 0; other_marks <= BitBoard::kFullMask; other_marks++) {
+        uint16_t expected = 0;
+        for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+          uint16_t cell_mask = static_cast<uint16_t>(1 << cell);
+          if (!((marks | other_marks) & cell_mask) && BitBoard::IsWinningMask(marks | cell_mask)) {
+            expected |= cell_mask;
+          }
+        }
+        REQUIRE(BitBoard::GetWinningCells(marks, other_marks) == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("Testing BitBoard's construction from a SuperBoard") {
+  SECTION("Empty board") {
+    BitBoard board{SuperBoard()};
+    REQUIRE(board.GetCurrentPlayer() == Player::kPlayer1);
+    REQUIRE(board.GetRequiredSubBoard() == BitBoard::kNoRequiredSubBoard);
+    REQUIRE(board.CountValidMoves() == 81);
+    REQUIRE(board.GetWinner() == WinState::kInProgress);
+  }
+
+  SECTION("Board with a won sub-board") {
+    SuperBoard super_board;
+    super_board.PlayMove({1, 2, 0, 2});
+    super_board.PlayMove({0, 2, 1, 2});
+    super_board.PlayMove({1, 2, 2, 2});
+    super_board.PlayMove({2, 2, 1, 2});
+    super_board.PlayMove({1, 2, 1, 2});
+    BitBoard board(super_board);
+    REQUIRE(board.GetMarks(Player::kPlayer1, 5) == 0444);
+    REQUIRE(board.GetMarks(Player::kPlayer2, 2) == 0040);
+    REQUIRE(board.GetWonSubBoards(Player::kPlayer1) == 1 << 5);
+    REQUIRE(board.GetCompleteSubBoards() == 1 << 5);
+    REQUIRE(board.GetCurrentPlayer() == Player::kPlayer2);
+
+    // The move sends Player 2 to the completed sub-board, so any sub-board is allowed.
+    REQUIRE(board.GetRequiredSubBoard() == BitBoard::kNoRequiredSubBoard);
+    REQUIRE(board.GetValidCellMask(5) == 0);
+    REQUIRE(board.CountValidMoves() == 81 - 9 - 2);
+
+    // The valid moves are counted by sub-board, then by cell.
+    size_t n = 0;
+    for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+      for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+        if (board.GetValidCellMask(sub_board) & (1 << cell)) {
+          REQUIRE(board.GetNthValidMove(n++) == BitBoard::ToAction(sub_board, cell));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Testing BitBoard's PlayMove method") {
+  SECTION("Moves match the equivalent SuperBoard moves") {
+    Action moves[] = {{1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2}, {1, 2, 1, 2}, {0, 0, 1, 1},
+                      {1, 1, 1, 0}, {1, 0, 1, 1}, {1, 1, 1, 2}, {2, 0, 1, 1}, {1, 1, 1, 1}, {2, 1, 1, 0},
+                      {1, 0, 0, 0}, {0, 0, 1, 0}, {1, 0, 0, 1}, {0, 1, 1, 0}, {1, 0, 0, 2}};
+    SuperBoard super_board;
+    BitBoard board;
+    for (const Action& a : moves) {
+      REQUIRE(board.GetValidCellMask(BitBoard::SubBoardIndex(a)) & (1 << BitBoard::CellIndex(a)));
+      super_board.PlayMove(a);
+      board.PlayMove(BitBoard::SubBoardIndex(a), BitBoard::CellIndex(a));
+
+      BitBoard expected(super_board);
+      REQUIRE(board.GetWinner() == super_board.GetWinner());
+      REQUIRE(board.GetRequiredSubBoard() == expected.GetRequiredSubBoard());
+      REQUIRE(board.GetCompleteSubBoards() == expected.GetCompleteSubBoards());
+      REQUIRE(board.GetCurrentPlayer() == super_board.GetCurrentPlayer());
+      REQUIRE(board.GetHash() == expected.GetHash());
+      REQUIRE(board.IsDeadDraw() == super_board.IsDeadDraw());
+    }
+    REQUIRE(board.GetWinner() == WinState::kPlayer1Win);
+    REQUIRE(board.CountValidMoves() == 0);
+  }
+
+  SECTION("Dead draws match SuperBoard's, including before the game is complete") {
+    XorShiftRandom random(3);
+    size_t num_early_dead_draws = 0;
+    for (size_t game = 0; game < 100; game++) {
+      SuperBoard super_board;
+      BitBoard board;
+      while (!board.IsComplete()) {
+        Action move = board.GetNthValidMove(random.NextBelow(board.CountValidMoves()));
+        super_board.PlayMove(move);
+        board.PlayMove(BitBoard::SubBoardIndex(move), BitBoard::CellIndex(move));
+        REQUIRE(board.IsDeadDraw() == super_board.IsDeadDraw());
+        if (board.IsDeadDraw() && !board.IsComplete()) {
+          num_early_dead_draws++;
+        }
+      }
+    }
+    REQUIRE(num_early_dead_draws > 0);
+  }
+
+  SECTION("Winning moves and game-winning sub-boards match a brute-force check") {
+    XorShiftRandom random(5);
+    size_t num_winning_positions = 0;
+    for (size_t game = 0; game < 100; game++) {
+      BitBoard board;
+      while (!board.IsComplete()) {
+        bool has_winning_move = false;
+        for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+          for (uint16_t valid_cells = board.GetValidCellMask(sub_board); valid_cells != 0;
+               valid_cells &= valid_cells - 1) {
+            BitBoard child = board;
+            child.PlayMove(sub_board, ultimate_tictactoe::SelectNthSetBit(valid_cells, 0));
+            if (child.IsComplete() && child.GetWinner() != WinState::kTie) {
+              has_winning_move = true;
+            }
+          }
+        }
+
+        for (Player player : {Player::kPlayer1, Player::kPlayer2}) {
+          uint16_t expected = 0;
+          for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+            uint16_t sub_board_mask = static_cast<uint16_t>(1 << sub_board);
+            if (!(board.GetCompleteSubBoards() & sub_board_mask) &&
+                BitBoard::IsWinningMask(board.GetWonSubBoards(player) | sub_board_mask)) {
+              expected |= sub_board_mask;
+            }
+          }
+          REQUIRE(board.GetGameWinningSubBoards(player) == expected);
+        }
+
+        size_t winning_sub_board = 0;
+        size_t winning_cell = 0;
+        REQUIRE(board.FindWinningMove(winning_sub_board, winning_cell) == has_winning_move);
+        if (has_winning_move) {
+          num_winning_positions++;
+          REQUIRE(board.GetValidCellMask(winning_sub_board) & (1 << winning_cell));
+          BitBoard child = board;
+          child.PlayMove(winning_sub_board, winning_cell);
+          REQUIRE(child.GetWinner() == (board.GetCurrentPlayer() == Player::kPlayer1 ? WinState::kPlayer1Win
+                                                                                     : WinState::kPlayer2Win));
+        }
+
+        Action move = board.GetNthValidMove(random.NextBelow(board.CountValidMoves()));
+        board.PlayMove(BitBoard::SubBoardIndex(move), BitBoard::CellIndex(move));
+      }
+    }
+    REQUIRE(num_winning_positions > 0);
+  }
+
+  SECTION("Hashes depend on the position, not the move order") {
+    BitBoard board;
+    board.PlayMove(4, 0);
+    board.PlayMove(0, 4);
+    board.PlayMove(4, 8);
+    board.PlayMove(8, 4);
+
+    BitBoard transposed_board;
+    transposed_board.PlayMove(4, 8);
+    transposed_board.PlayMove(8, 4);
+    REQUIRE(transposed_board.GetHash() != board.GetHash());
+    transposed_board.PlayMove(4, 0);
+    transposed_board.PlayMove(0, 4);
+    REQUIRE(transposed_board.GetHash() == board.GetHash());
+
+    BitBoard other_board;
+    other_board.PlayMove(4, 0);
+    other_board.PlayMove(0, 4);
+    REQUIRE(other_board.GetHash() != board.GetHash());
+    REQUIRE(BitBoard().GetHash() != board.GetHash());
+  }
+
+  SECTION("Conversions between actions and indices") {
+    Action a = {1, 2, 0, 1};
+    REQUIRE(BitBoard::SubBoardIndex(a) == 5);
+    REQUIRE(BitBoard::CellIndex(a) == 1);
+    REQUIRE(BitBoard::ToAction(5, 1) == a);
+  }
+}
+
+TEST_CASE("Testing BitBoard's symmetries") {
+  Action moves[] = {{1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2}, {1, 2, 1, 2}, {0, 0, 1, 1}};
+
+  SECTION("Transformed positions match the positions reached by the transformed moves") {
+    for (size_t symmetry = 0; symmetry < BitBoard::kNumSymmetries; symmetry++) {
+      SuperBoard board;
+      SuperBoard transformed_board;
+      for (const Action& a : moves) {
+        board.PlayMove(a);
+        transformed_board.PlayMove(BitBoard::TransformAction(symmetry, a));
+      }
+
+      BitBoard transformed = BitBoard(board).GetTransformed(symmetry);
+      BitBoard expected(transformed_board);
+      REQUIRE(transformed.GetHash() == expected.GetHash());
+      REQUIRE(transformed.GetRequiredSubBoard() == expected.GetRequiredSubBoard());
+      REQUIRE(transformed.GetCompleteSubBoards() == expected.GetCompleteSubBoards());
+      REQUIRE(transformed.GetWonSubBoards(Player::kPlayer1) == expected.GetWonSubBoards(Player::kPlayer1));
+      REQUIRE(BitBoard(board).GetCanonicalHash() == expected.GetCanonicalHash());
+    }
+  }
+
+  SECTION("Inverse symmetries undo the symmetries") {
+    for (size_t symmetry = 0; symmetry < BitBoard::kNumSymmetries; symmetry++) {
+      for (size_t index = 0; index < BitBoard::kNumCells; index++) {
+        REQUIRE(BitBoard::TransformIndex(BitBoard::InverseSymmetry(symmetry),
+                                         BitBoard::TransformIndex(symmetry, index)) == index);
+      }
+    }
+  }
+
+  SECTION("Stabilizer symmetries transform the position into itself") {
+    BitBoard board;
+    REQUIRE(board.GetStabilizerSymmetries() == 0xFF);
+
+    // After a move in the center of the center sub-board, every symmetry still applies.
+    board.PlayMove(4, 4);
+    REQUIRE(board.GetStabilizerSymmetries() == 0xFF);
+
+    // After a move in a corner cell of the center sub-board, only the identity and the
+    // reflection across the main diagonal (which fixes that corner) apply.
+    board.PlayMove(4, 0);
+    REQUIRE(board.GetStabilizerSymmetries() == ((1 << 0) | (1 << 6)));
+
+    XorShiftRandom random(9);
+    for (size_t game = 0; game < 20; game++) {
+      BitBoard random_board;
+      for (size_t move_num = 0; move_num < 6 && !random_board.IsComplete(); move_num++) {
+        Action move = random_board.GetNthValidMove(random.NextBelow(random_board.CountValidMoves()));
+        random_board.PlayMove(BitBoard::SubBoardIndex(move), BitBoard::CellIndex(move));
+        for (size_t symmetry = 0; symmetry < BitBoard::kNumSymmetries; symmetry++) {
+          bool is_stabilizer = (random_board.GetTransformed(symmetry).GetHash() == random_board.GetHash());
+          REQUIRE(((random_board.GetStabilizerSymmetries() >> symmetry) & 1) == is_stabilizer);
+        }
+      }
+    }
+  }
+
+  SECTION("Canonical symmetries give the canonical hash") {
+    BitBoard board;
+    board.PlayMove(0, 5);
+    size_t symmetry = board.GetCanonicalSymmetry();
+    REQUIRE(board.GetTransformed(symmetry).GetHash() == board.GetCanonicalHash());
+    REQUIRE(board.GetCanonicalHash() <= board.GetHash());
+  }
+}
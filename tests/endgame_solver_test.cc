@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/endgame_solver.h>
+#include <core/random_playout.h>
+#include <core/tree_search_ai.h>
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::EndgameSolution;
+using ultimate_tictactoe::EndgameSolver;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+using ultimate_tictactoe::WinState;
+using ultimate_tictactoe::XorShiftRandom;
+
+namespace {
+
+// Plays random moves from the start of the game until at most max_open_cells open cells are
+// left. Returns false if the game ended before that.
+bool PlayRandomGameUntilEndgame(XorShiftRandom& random, size_t max_open_cells, SuperBoard& board) {
+  board = SuperBoard();
+  while (!board.IsComplete() && BitBoard(board).CountOpenCells() > max_open_cells) {
+    BitBoard bit_board(board);
+    board.PlayMove(bit_board.GetNthValidMove(random.NextBelow(bit_board.CountValidMoves())));
+  }
+  return !board.IsComplete();
+}
+
+// Minimax without pruning or a table, scored like the solver: winning after d plies scores
+// 1000 - d, losing after d plies scores d - 1000, and a draw scores 0.
+int SolveByMinimax(const BitBoard& board, int ply) {
+  WinState winner = board.GetWinner();
+  if (winner == WinState::kTie) {
+    return 0;
+  } else if (winner != WinState::kInProgress) {
+    return -(1000 - ply);
+  }
+
+  int best_score = -1000;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+      if (board.GetValidCellMask(sub_board) & (1 << cell)) {
+        BitBoard child = board;
+        child.PlayMove(sub_board, cell);
+        best_score = std::max(best_score, -SolveByMinimax(child, ply + 1));
+      }
+    }
+  }
+  return best_score;
+}
+
+}  // namespace
+
+TEST_CASE("Testing EndgameSolver") {
+  XorShiftRandom random(5);
+
+  SECTION("Solutions match minimax") {
+    EndgameSolver solver;
+    size_t num_positions = 0;
+    while (num_positions < 30) {
+      SuperBoard board;
+      if (!PlayRandomGameUntilEndgame(random, 8, board)) {
+        continue;
+      }
+      num_positions++;
+
+      BitBoard bit_board(board);
+      int score = SolveByMinimax(bit_board, 0);
+      EndgameSolution solution;
+      REQUIRE(solver.Solve(bit_board, solution));
+      if (score > 0) {
+        REQUIRE(solution.outcome == 1);
+        REQUIRE(solution.distance_to_end == static_cast<size_t>(1000 - score));
+      } else if (score < 0) {
+        REQUIRE(solution.outcome == -1);
+        REQUIRE(solution.distance_to_end == static_cast<size_t>(1000 + score));
+      } else {
+        REQUIRE(solution.outcome == 0);
+      }
+
+      // The best move leads to the same result.
+      REQUIRE(board.IsValidMove(solution.best_move));
+      BitBoard child = bit_board;
+      child.PlayMove(BitBoard::SubBoardIndex(solution.best_move), BitBoard::CellIndex(solution.best_move));
+      REQUIRE(-SolveByMinimax(child, 1) == score);
+    }
+  }
+
+  SECTION("Solving gives up when the node budget runs out") {
+    SuperBoard board;
+    while (!PlayRandomGameUntilEndgame(random, 12, board)) {}
+    EndgameSolver solver(10, 1);
+    EndgameSolution solution;
+    REQUIRE_FALSE(solver.Solve(BitBoard(board), solution));
+    REQUIRE(solver.GetNodesSearched() > 1);
+  }
+
+  SECTION("Complete games cannot be solved") {
+    EndgameSolver solver;
+    EndgameSolution solution;
+    BitBoard complete_board;
+    while (!complete_board.IsComplete()) {
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        if (complete_board.GetValidCellMask(sub_board) != 0) {
+          complete_board.PlayMove(sub_board,
+                                  ultimate_tictactoe::SelectNthSetBit(complete_board.GetValidCellMask(sub_board), 0));
+          break;
+        }
+      }
+    }
+    REQUIRE_THROWS_AS(solver.Solve(complete_board, solution), std::runtime_error);
+  }
+}
+
+TEST_CASE("Testing TreeSearchAI's endgame solving") {
+  XorShiftRandom random(11);
+  SuperBoard board;
+  while (!PlayRandomGameUntilEndgame(random, 10, board)) {}
+  EndgameSolver solver;
+  EndgameSolution solution;
+  REQUIRE(solver.Solve(BitBoard(board), solution));
+
+  TreeSearchAI AI;
+  AI.SetState(board);
+  AI.SetSearchDepth(2);
+  AI.SetEndgameSolverThreshold(TreeSearchAI::kSuggestedEndgameSolverThreshold);
+
+  SECTION("Endgames are solved instead of searched") {
+    REQUIRE(AI.GetMove() == solution.best_move);
+    REQUIRE(AI.GetSearchStats().endgame_solves == 1);
+    REQUIRE(AI.GetSearchStats().leaf_evaluations == 0);
+    double expected_value =
+        solution.outcome * (TreeSearchAI::kWinValue - solution.distance_to_end * TreeSearchAI::kWinDistanceStep);
+    REQUIRE(AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, 2).second ==
+            Approx(expected_value));
+  }
+
+  SECTION("The stepped search solves endgames like GetMove") {
+    // Only the states after the first move are solved.
+    AI.SetEndgameSolverThreshold(BitBoard(board).CountOpenCells() - 1);
+    Action move = AI.GetMove();
+    REQUIRE(AI.GetSearchStats().endgame_solves > 0);
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    REQUIRE(AI.FinishSteppedSearch() == move);
+  }
+
+  SECTION("The solver is not tried again below a state it gave up on") {
+    // The empty board is far too large to solve within the solver's node budget.
+    AI.SetState(SuperBoard());
+    AI.SetEndgameSolverThreshold(BitBoard::kNumCells * BitBoard::kNumCells);
+    Action move = AI.GetMove();
+    REQUIRE(AI.GetSearchStats().endgame_solver_failures == 1);
+    REQUIRE(AI.GetSearchStats().endgame_solves == 0);
+    REQUIRE(AI.GetSearchStats().leaf_evaluations > 0);
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    REQUIRE(AI.FinishSteppedSearch() == move);
+    REQUIRE(AI.GetSearchStats().endgame_solver_failures == 1);
+  }
+
+  SECTION("The solver can be disabled") {
+    AI.SetEndgameSolverThreshold(0);
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().endgame_solves == 0);
+    REQUIRE(AI.GetSearchStats().leaf_evaluations > 0);
+  }
+}
+
+TEST_CASE("Testing TreeSearchAI's mate distances") {
+  XorShiftRandom random(17);
+
+  SECTION("Searching to the end of the game finds the solver's distances") {
+    size_t num_positions = 0;
+    while (num_positions < 20) {
+      SuperBoard board;
+      if (!PlayRandomGameUntilEndgame(random, 8, board)) {
+        continue;
+      }
+      num_positions++;
+
+      EndgameSolver solver;
+      EndgameSolution solution;
+      REQUIRE(solver.Solve(BitBoard(board), solution));
+      TreeSearchAI AI;
+      AI.SetState(board);
+      double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, 81).second;
+      if (solution.outcome == 0) {
+        REQUIRE(value == 0);
+      } else {
+        REQUIRE(TreeSearchAI::IsWinOrLossValue(value));
+        REQUIRE((value > 0) == (solution.outcome > 0));
+        REQUIRE(TreeSearchAI::GetPliesToEnd(value) == solution.distance_to_end);
+      }
+    }
+  }
+
+  SECTION("Heuristic values are not wins or losses") {
+    TreeSearchAI AI;
+    AI.UpdateState({1, 1, 1, 1});
+    REQUIRE_FALSE(TreeSearchAI::IsWinOrLossValue(AI.EvaluateState()));
+    REQUIRE_FALSE(TreeSearchAI::IsWinOrLossValue(0));
+    REQUIRE(TreeSearchAI::IsWinOrLossValue(-TreeSearchAI::kWinValue));
+    REQUIRE(TreeSearchAI::GetPliesToEnd(-TreeSearchAI::kWinValue) == 0);
+  }
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <core/evaluation_cache.h>
+#include <core/superboard.h>
+#include <core/tree_search_ai.h>
+
+using ultimate_tictactoe::BasicTreeSearchAI;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::EvaluationCache;
+using ultimate_tictactoe::NeuralEvaluator;
+using ultimate_tictactoe::NeuralNetworkWeights;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+
+TEST_CASE("Testing EvaluationCache") {
+  EvaluationCache cache(4);
+  double value = 0;
+
+  SECTION("Stored values are found by their hash") {
+    REQUIRE(cache.IsEnabled());
+    REQUIRE_FALSE(cache.Probe(17, value));
+    cache.Store(17, 0.25);
+    REQUIRE(cache.Probe(17, value));
+    REQUIRE(value == 0.25);
+    REQUIRE_FALSE(cache.Probe(18, value));
+  }
+
+  SECTION("A value replaces the value of another hash in the same slot") {
+    cache.Store(1, 0.5);
+    cache.Store(1 + 16, -0.5);
+    REQUIRE_FALSE(cache.Probe(1, value));
+    REQUIRE(cache.Probe(1 + 16, value));
+    REQUIRE(value == -0.5);
+  }
+
+  SECTION("Clearing discards stored values") {
+    cache.Store(3, 0.75);
+    cache.Clear();
+    REQUIRE_FALSE(cache.Probe(3, value));
+    cache.Store(3, 0.125);
+    REQUIRE(cache.Probe(3, value));
+    REQUIRE(value == 0.125);
+  }
+
+  SECTION("A cache of size 0 stores nothing") {
+    EvaluationCache disabled_cache(0);
+    REQUIRE_FALSE(disabled_cache.IsEnabled());
+    disabled_cache.Store(5, 0.5);
+    REQUIRE_FALSE(disabled_cache.Probe(5, value));
+  }
+
+  SECTION("Sizes larger than the maximum are rejected") {
+    REQUIRE_THROWS_AS(EvaluationCache(EvaluationCache::kMaxSizeLog2 + 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(EvaluationCache(64), std::invalid_argument);
+    TreeSearchAI AI;
+    REQUIRE_THROWS_AS(AI.SetEvaluationCacheSize(64), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing the evaluation cache in the search") {
+  SuperBoard board;
+  board.PlayMove(BitBoard::ToAction(4, 4));
+  board.PlayMove(BitBoard::ToAction(4, 0));
+  board.PlayMove(BitBoard::ToAction(0, 8));
+
+  SECTION("Searches find the same values and visit the same nodes with and without the cache") {
+    TreeSearchAI AI;
+    TreeSearchAI uncached_AI;
+    uncached_AI.SetEvaluationCacheSize(0);
+    AI.SetState(board);
+    uncached_AI.SetState(board);
+    for (size_t depth = 1; depth <= 5; depth++) {
+      double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, depth).second;
+      REQUIRE(value ==
+              uncached_AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, depth).second);
+    }
+    REQUIRE(AI.GetSearchStats().nodes == uncached_AI.GetSearchStats().nodes);
+    REQUIRE(uncached_AI.GetSearchStats().eval_cache_probes == 0);
+
+    // Iterative deepening reaches leaves of the previous iterations again.
+    REQUIRE(AI.GetSearchStats().eval_cache_hits > 0);
+    REQUIRE(AI.GetSearchStats().eval_cache_hits < AI.GetSearchStats().eval_cache_probes);
+
+    AI.SetSearchDepth(4);
+    uncached_AI.SetSearchDepth(4);
+    REQUIRE(AI.GetMove() == uncached_AI.GetMove());
+  }
+
+  SECTION("Invalidating the cache after changing the evaluator discards cached values") {
+    BasicTreeSearchAI<NeuralEvaluator> AI;
+    AI.SetState(board);
+    REQUIRE(AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, 2).second == 0);
+
+    // With other weights, the leaves get other values, which must not come from the cache.
+    std::unique_ptr<NeuralNetworkWeights> weights(new NeuralNetworkWeights(AI.GetEvaluator().GetWeights()));
+    weights->output_bias = 4096;
+    AI.GetEvaluator().SetWeights(*weights);
+    AI.InvalidateEvaluationCache();
+    BasicTreeSearchAI<NeuralEvaluator> fresh_AI;
+    fresh_AI.GetEvaluator().SetWeights(*weights);
+    fresh_AI.SetState(board);
+    double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, 2).second;
+    REQUIRE(value != 0);
+    REQUIRE(value == fresh_AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, 2).second);
+  }
+
+  SECTION("Resizing or invalidating the cache abandons the stepped search and discards pondered replies") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(2);
+    AI.SetState(board);
+    AI.BeginSteppedSearch();
+    AI.SetEvaluationCacheSize(EvaluationCache::kDefaultSizeLog2 - 1);
+    REQUIRE_FALSE(AI.IsSteppedSearchRunning());
+    AI.BeginSteppedSearch();
+    AI.InvalidateEvaluationCache();
+    REQUIRE_FALSE(AI.IsSteppedSearchRunning());
+
+    AI.SetState(SuperBoard());
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartPondering();
+    while (AI.IsPondering()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    AI.SetEvaluationCacheSize(EvaluationCache::kDefaultSizeLog2);
+    AI.UpdateState({0, 2, 1, 2});
+    REQUIRE_FALSE(AI.HasPonderedReply());
+  }
+}
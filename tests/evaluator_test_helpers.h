@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <core/bitboard.h>
+#include <core/player.h>
+#include <core/position_batch.h>
+#include <core/tree_search_ai.h>
+#include <core/win_state.h>
+
+namespace ultimate_tictactoe {
+namespace testing {
+
+// Adds every child of the board to the end of the batch and of children, in the order the
+// search visits the moves.
+inline void AddChildren(const BitBoard& board, PositionBatch& batch, std::vector<BitBoard>& children) {
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+      if (board.GetValidCellMask(sub_board) & (1 << cell)) {
+        children.push_back(board);
+        children.back().PlayMove(sub_board, cell);
+        batch.Add(children.back(), sub_board, cell);
+      }
+    }
+  }
+}
+
+// A plain negamax search, with the same values as TreeSearchAI's search, that evaluates every
+// leaf on its own with Evaluator::Evaluate.
+template <typename Evaluator>
+double Negamax(const BitBoard& board, const Evaluator& evaluator, size_t depth, size_t ply) {
+  if (board.IsComplete() || (ply > 0 && board.IsDeadDraw())) {
+    WinState winner = board.GetWinner();
+    if (winner != WinState::kPlayer1Win && winner != WinState::kPlayer2Win) {
+      return 0;
+    }
+    double win_value = TreeSearchAI::kWinValue - static_cast<double>(ply) * TreeSearchAI::kWinDistanceStep;
+    bool current_player_won = (winner == WinState::kPlayer1Win) == (board.GetCurrentPlayer() == Player::kPlayer1);
+    return current_player_won ? win_value : -win_value;
+  }
+  if (depth == 0) {
+    return evaluator.Evaluate(board);
+  }
+  double best_value = -TreeSearchAI::kWinValue;
+  for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+    for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+      if (board.GetValidCellMask(sub_board) & (1 << cell)) {
+        BitBoard child = board;
+        child.PlayMove(sub_board, cell);
+        best_value = std::max(best_value, -Negamax(child, evaluator, depth - 1, ply + 1));
+      }
+    }
+  }
+  return best_value;
+}
+
+}  // namespace testing
+}  // namespace ultimate_tictactoe
@@ -0,0 +1,40 @@
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/heuristic_evaluator.h>
+#include <core/random_playout.h>
+#include <core/superboard.h>
+#include <core/tree_search_ai.h>
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::HeuristicEvaluator;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+using ultimate_tictactoe::XorShiftRandom;
+
+TEST_CASE("Testing HeuristicEvaluator") {
+  SECTION("Empty board is even") {
+    HeuristicEvaluator evaluator;
+    REQUIRE(evaluator.Evaluate(BitBoard()) == 0);
+  }
+
+  SECTION("Values are exactly those of TreeSearchAI::EvaluateState over random games") {
+    HeuristicEvaluator evaluator;
+    TreeSearchAI AI;
+    XorShiftRandom random(11);
+    size_t num_positions = 0;
+    for (size_t game = 0; game < 100; game++) {
+      SuperBoard super_board;
+      BitBoard board;
+      while (!board.IsComplete()) {
+        Action move = board.GetNthValidMove(random.NextBelow(board.CountValidMoves()));
+        super_board.PlayMove(move);
+        board.PlayMove(BitBoard::SubBoardIndex(move), BitBoard::CellIndex(move));
+        AI.SetState(super_board);
+        REQUIRE(evaluator.Evaluate(board) == AI.EvaluateState());
+        num_positions++;
+      }
+    }
+    REQUIRE(num_positions > 1000);
+  }
+}
@@ -0,0 +1,227 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/neural_evaluator.h>
+#include <core/position_batch.h>
+#include <core/random_playout.h>
+#include <core/tree_search_ai.h>
+
+#include "evaluator_test_helpers.h"
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::BasicTreeSearchAI;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::NeuralEvaluator;
+using ultimate_tictactoe::NeuralNetworkWeights;
+using ultimate_tictactoe::Player;
+using ultimate_tictactoe::PositionBatch;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+using ultimate_tictactoe::XorShiftRandom;
+using ultimate_tictactoe::testing::AddChildren;
+using ultimate_tictactoe::testing::Negamax;
+
+namespace {
+
+const std::string kWeightsPath = "neural_evaluator_test.bin";
+
+// Returns weights drawn uniformly from small ranges, so that the network's values vary.
+std::unique_ptr<NeuralNetworkWeights> MakeRandomWeights(uint64_t seed) {
+  XorShiftRandom random(seed);
+  std::unique_ptr<NeuralNetworkWeights> weights(new NeuralNetworkWeights());
+  for (size_t feature = 0; feature < NeuralNetworkWeights::kNumFeatures; feature++) {
+    for (size_t i = 0; i < NeuralNetworkWeights::kAccumulatorSize; i++) {
+      weights->feature_weights[feature][i] = static_cast<int16_t>(random.NextBelow(33)) - 16;
+    }
+  }
+  for (size_t i = 0; i < NeuralNetworkWeights::kAccumulatorSize; i++) {
+    weights->feature_biases[i] = static_cast<int16_t>(random.NextBelow(65));
+  }
+  for (size_t i = 0; i < NeuralNetworkWeights::kHiddenSize; i++) {
+    for (size_t j = 0; j < 2 * NeuralNetworkWeights::kAccumulatorSize; j++) {
+      weights->hidden1_weights[i][j] = static_cast<int8_t>(static_cast<int>(random.NextBelow(129)) - 64);
+    }
+    for (size_t j = 0; j < NeuralNetworkWeights::kHiddenSize; j++) {
+      weights->hidden2_weights[i][j] = static_cast<int8_t>(static_cast<int>(random.NextBelow(129)) - 64);
+    }
+    weights->hidden1_biases[i] = static_cast<int32_t>(random.NextBelow(2049)) - 1024;
+    weights->hidden2_biases[i] = static_cast<int32_t>(random.NextBelow(2049)) - 1024;
+    weights->output_weights[i] = static_cast<int8_t>(static_cast<int>(random.NextBelow(129)) - 64);
+  }
+  weights->output_bias = 100;
+  return weights;
+}
+
+// Plays a random valid move on the board, returning it as (sub_board, cell).
+std::pair<size_t, size_t> PlayRandomMove(BitBoard& board, XorShiftRandom& random) {
+  Action move = board.GetNthValidMove(random.NextBelow(board.CountValidMoves()));
+  size_t sub_board = BitBoard::SubBoardIndex(move);
+  size_t cell = BitBoard::CellIndex(move);
+  board.PlayMove(sub_board, cell);
+  return {sub_board, cell};
+}
+
+}  // namespace
+
+TEST_CASE("Testing NeuralEvaluator") {
+  std::unique_ptr<NeuralNetworkWeights> weights = MakeRandomWeights(7);
+
+  SECTION("Zero weights evaluate every state as even") {
+    NeuralEvaluator evaluator;
+    BitBoard board;
+    XorShiftRandom random(1);
+    for (size_t i = 0; i < 20; i++) {
+      REQUIRE(evaluator.Evaluate(board) == 0);
+      PlayRandomMove(board, random);
+    }
+  }
+
+  SECTION("Incremental updates give the same values as computing the accumulators from the board") {
+    NeuralEvaluator incremental_evaluator;
+    NeuralEvaluator evaluator;
+    incremental_evaluator.SetWeights(*weights);
+    evaluator.SetWeights(*weights);
+    XorShiftRandom random(5);
+    size_t num_distinct_values = 0;
+    for (size_t game = 0; game < 50; game++) {
+      BitBoard board;
+      std::vector<BitBoard> history(1, board);
+      incremental_evaluator.Reset(board);
+      while (!board.IsComplete()) {
+        Player player = board.GetCurrentPlayer();
+        std::pair<size_t, size_t> move = PlayRandomMove(board, random);
+        incremental_evaluator.PlayMove(player, move.first, move.second);
+        history.push_back(board);
+        double value = incremental_evaluator.Evaluate(board);
+        REQUIRE(value == evaluator.Evaluate(board));
+        REQUIRE(value > -1);
+        REQUIRE(value < 1);
+        if (value != evaluator.Evaluate(history[history.size() - 2])) {
+          num_distinct_values++;
+        }
+      }
+
+      // Reversing the moves restores the earlier accumulators.
+      for (size_t i = 0; i < 5 && history.size() > 1; i++) {
+        incremental_evaluator.ReverseMove();
+        history.pop_back();
+        REQUIRE(incremental_evaluator.Evaluate(history.back()) == evaluator.Evaluate(history.back()));
+      }
+    }
+    REQUIRE(num_distinct_values > 1000);
+  }
+
+  SECTION("Batches of children get the values of playing each child's move and evaluating") {
+    NeuralEvaluator incremental_evaluator;
+    NeuralEvaluator evaluator;
+    incremental_evaluator.SetWeights(*weights);
+    evaluator.SetWeights(*weights);
+    XorShiftRandom random(11);
+    BitBoard board;
+    incremental_evaluator.Reset(board);
+    while (!board.IsComplete()) {
+      PositionBatch batch;
+      std::vector<BitBoard> children;
+      AddChildren(board, batch, children);
+
+      // From the accumulators of the followed state, and computed from the positions' marks.
+      double values[PositionBatch::kMaxSize];
+      double computed_values[PositionBatch::kMaxSize];
+      incremental_evaluator.EvaluateBatch(batch, values);
+      evaluator.EvaluateBatch(batch, computed_values);
+      for (size_t i = 0; i < children.size(); i++) {
+        REQUIRE(values[i] == evaluator.Evaluate(children[i]));
+        REQUIRE(computed_values[i] == values[i]);
+      }
+
+      Player player = board.GetCurrentPlayer();
+      std::pair<size_t, size_t> move = PlayRandomMove(board, random);
+      incremental_evaluator.PlayMove(player, move.first, move.second);
+    }
+  }
+
+  SECTION("Weights are written to and loaded from files") {
+    NeuralEvaluator::Write(kWeightsPath, *weights);
+    NeuralEvaluator loaded_evaluator;
+    loaded_evaluator.Load(kWeightsPath);
+    NeuralEvaluator evaluator;
+    evaluator.SetWeights(*weights);
+
+    BitBoard board;
+    XorShiftRandom random(3);
+    for (size_t i = 0; i < 30 && !board.IsComplete(); i++) {
+      REQUIRE(loaded_evaluator.Evaluate(board) == evaluator.Evaluate(board));
+      PlayRandomMove(board, random);
+    }
+    std::remove(kWeightsPath.c_str());
+  }
+
+  SECTION("Invalid weight files are not loaded") {
+    NeuralEvaluator evaluator;
+    REQUIRE_THROWS_AS(evaluator.Load("missing_neural_evaluator_test.bin"), std::runtime_error);
+    {
+      std::ofstream file(kWeightsPath, std::ios::binary);
+      file << "not a weight file";
+    }
+    REQUIRE_THROWS_AS(evaluator.Load(kWeightsPath), std::runtime_error);
+    std::remove(kWeightsPath.c_str());
+    REQUIRE_THROWS_AS(ultimate_tictactoe::MakeTreeSearchAI(ultimate_tictactoe::EvaluatorType::kNeural, kWeightsPath),
+                      std::runtime_error);
+  }
+
+  SECTION("Searches with the evaluator, which updates it incrementally, match a plain negamax search") {
+    NeuralEvaluator reference_evaluator;
+    reference_evaluator.SetWeights(*weights);
+    XorShiftRandom random(9);
+    for (size_t game = 0; game < 4; game++) {
+      SuperBoard super_board;
+      BitBoard board;
+      for (size_t i = 0; i < 10 + 5 * game && !board.IsComplete(); i++) {
+        std::pair<size_t, size_t> move = PlayRandomMove(board, random);
+        super_board.PlayMove(BitBoard::ToAction(move.first, move.second));
+      }
+      if (board.IsComplete()) {
+        continue;
+      }
+
+      BasicTreeSearchAI<NeuralEvaluator> AI;
+      AI.GetEvaluator().SetWeights(*weights);
+      AI.SetState(super_board);
+      for (size_t depth = 1; depth <= 4; depth++) {
+        double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, depth).second;
+        REQUIRE(value == Negamax(board, reference_evaluator, depth, 0));
+      }
+
+      // The stepped search follows the same moves with the evaluator.
+      AI.SetSearchDepth(4);
+      Action expected_move = AI.GetMove();
+      size_t expected_nodes = AI.GetSearchStats().nodes;
+      AI.BeginSteppedSearch();
+      while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+      REQUIRE(AI.FinishSteppedSearch() == expected_move);
+      REQUIRE(AI.GetSearchStats().nodes == expected_nodes);
+    }
+  }
+
+  SECTION("Searches from symmetric states search every action, since the evaluator is not symmetric") {
+    NeuralEvaluator reference_evaluator;
+    reference_evaluator.SetWeights(*weights);
+    BasicTreeSearchAI<NeuralEvaluator> AI;
+    AI.GetEvaluator().SetWeights(*weights);
+    for (size_t depth = 1; depth <= 3; depth++) {
+      double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, depth).second;
+      REQUIRE(value == Negamax(BitBoard(), reference_evaluator, depth, 0));
+    }
+    AI.SetSearchDepth(2);
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().symmetric_actions_skipped == 0);
+  }
+}
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/opening_book.h>
+#include <core/opening_book_builder.h>
+#include <core/tree_search_ai.h>
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::OpeningBook;
+using ultimate_tictactoe::OpeningBookBuilder;
+using ultimate_tictactoe::OpeningBookEntry;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+
+namespace {
+
+const std::string kBookPath = "opening_book_test.bin";
+
+}  // namespace
+
+TEST_CASE("Testing OpeningBookBuilder") {
+  SECTION("Positions equivalent by symmetry are only included once") {
+    // The empty board, and the 15 classes of first moves
+    REQUIRE(OpeningBookBuilder(2, 1, 1).GetPositions().size() == 16);
+    REQUIRE(OpeningBookBuilder(0, 1, 1).GetPositions().empty());
+  }
+
+  SECTION("Invalid arguments") {
+    REQUIRE_THROWS_AS(OpeningBookBuilder(2, 0, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(OpeningBookBuilder(2, 1, 0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing OpeningBook") {
+  const size_t kSearchDepth = 2;
+  OpeningBookBuilder builder(3, kSearchDepth, 4);
+  std::vector<OpeningBookEntry> entries = builder.Build();
+  OpeningBook::Write(kBookPath, entries);
+  OpeningBook book;
+  book.Open(kBookPath);
+  REQUIRE(book.IsOpen());
+  REQUIRE(book.GetNumEntries() == builder.GetPositions().size());
+
+  SECTION("Book moves match the searched moves") {
+    for (const SuperBoard& board : builder.GetPositions()) {
+      TreeSearchAI AI;
+      AI.SetState(board);
+      AI.SetSearchDepth(kSearchDepth);
+      Action move;
+      REQUIRE(book.Probe(board, kSearchDepth, move));
+      REQUIRE(move == AI.GetMove());
+    }
+  }
+
+  SECTION("Symmetric positions are found in the book") {
+    Action moves[] = {{1, 2, 0, 2}, {0, 2, 1, 2}};
+    for (size_t symmetry = 0; symmetry < BitBoard::kNumSymmetries; symmetry++) {
+      SuperBoard board;
+      for (const Action& a : moves) {
+        board.PlayMove(BitBoard::TransformAction(symmetry, a));
+      }
+      Action move;
+      REQUIRE(book.Probe(board, kSearchDepth, move));
+      REQUIRE(board.IsValidMove(move));
+    }
+  }
+
+  SECTION("Positions not in the book or searched too shallowly are not found") {
+    SuperBoard board;
+    board.PlayMove({1, 2, 0, 2});
+    board.PlayMove({0, 2, 1, 2});
+    board.PlayMove({1, 2, 2, 2});
+    Action move;
+    REQUIRE_FALSE(book.Probe(board, kSearchDepth, move));
+    REQUIRE_FALSE(book.Probe(SuperBoard(), kSearchDepth + 1, move));
+  }
+
+  SECTION("The AI plays book moves without searching") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(kSearchDepth);
+    AI.SetOpeningBook(&book);
+    Action book_move;
+    REQUIRE(book.Probe(SuperBoard(), kSearchDepth, book_move));
+    REQUIRE(AI.GetMove() == book_move);
+    REQUIRE(AI.GetSearchStats().nodes == 0);
+    REQUIRE(AI.GetPrincipalVariation() == std::vector<Action>(1, book_move));
+
+    AI.StartSearch();
+    REQUIRE(AI.FinishSearch() == book_move);
+
+    AI.BeginSteppedSearch();
+    REQUIRE(AI.StepSearch(std::chrono::milliseconds(0)));
+    REQUIRE(AI.FinishSteppedSearch() == book_move);
+
+    // Deeper searches are not answered by the book.
+    AI.SetSearchDepth(kSearchDepth + 1);
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().nodes > 0);
+  }
+
+  SECTION("Setting the book discards pondered replies") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(kSearchDepth);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartPondering();
+    while (AI.IsPondering()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    AI.SetOpeningBook(&book);
+    AI.UpdateState({0, 2, 1, 2});
+    REQUIRE_FALSE(AI.HasPonderedReply());
+  }
+
+  SECTION("Closing the book") {
+    book.Close();
+    REQUIRE_FALSE(book.IsOpen());
+    Action move;
+    REQUIRE_FALSE(book.Probe(SuperBoard(), kSearchDepth, move));
+  }
+
+  std::remove(kBookPath.c_str());
+}
+
+TEST_CASE("Testing OpeningBook's invalid files") {
+  OpeningBook book;
+  REQUIRE_THROWS_AS(book.Open("missing_opening_book_test.bin"), std::runtime_error);
+
+  {
+    std::ofstream file(kBookPath, std::ios::binary);
+    file << "not an opening book";
+  }
+  REQUIRE_THROWS_AS(book.Open(kBookPath), std::runtime_error);
+  REQUIRE_FALSE(book.IsOpen());
+  std::remove(kBookPath.c_str());
+}
+
+TEST_CASE("Testing an empty OpeningBook") {
+  OpeningBook::Write(kBookPath, {});
+  OpeningBook book;
+  book.Open(kBookPath);
+  REQUIRE(book.IsOpen());
+  REQUIRE(book.GetNumEntries() == 0);
+  Action move;
+  REQUIRE_FALSE(book.Probe(SuperBoard(), 0, move));
+  book.Close();
+  REQUIRE_FALSE(book.IsOpen());
+  std::remove(kBookPath.c_str());
+}
@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/pattern_evaluator.h>
+#include <core/pattern_trainer.h>
+#include <core/position_batch.h>
+#include <core/random_playout.h>
+#include <core/tree_search_ai.h>
+
+#include "evaluator_test_helpers.h"
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::BasicTreeSearchAI;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::PatternEvaluator;
+using ultimate_tictactoe::PatternTrainer;
+using ultimate_tictactoe::Player;
+using ultimate_tictactoe::PositionBatch;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+using ultimate_tictactoe::WinState;
+using ultimate_tictactoe::XorShiftRandom;
+using ultimate_tictactoe::testing::AddChildren;
+using ultimate_tictactoe::testing::Negamax;
+
+namespace {
+
+const std::string kWeightsPath = "pattern_evaluator_test.bin";
+
+std::vector<float> MakeRandomWeights(uint64_t seed) {
+  XorShiftRandom random(seed);
+  std::vector<float> weights(PatternEvaluator::kNumWeights);
+  for (float& weight : weights) {
+    weight = static_cast<float>(static_cast<int>(random.NextBelow(201)) - 100) / 1000;
+  }
+  return weights;
+}
+
+// Plays random moves until the game is complete, returning the moves and the positions before them.
+std::vector<Action> PlayRandomGame(XorShiftRandom& random, std::vector<BitBoard>& positions) {
+  std::vector<Action> moves;
+  BitBoard board;
+  while (!board.IsComplete()) {
+    positions.push_back(board);
+    Action move = board.GetNthValidMove(random.NextBelow(board.CountValidMoves()));
+    moves.push_back(move);
+    board.PlayMove(BitBoard::SubBoardIndex(move), BitBoard::CellIndex(move));
+  }
+  return moves;
+}
+
+// Returns true iff the player can still win along a line of sub-boards through the sub-board.
+bool IsOnOpenLine(const BitBoard& board, Player player, size_t sub_board) {
+  uint16_t blocked = board.GetCompleteSubBoards() & ~board.GetWonSubBoards(player);
+  for (uint16_t line : BitBoard::kLineMasks) {
+    if ((line & (1 << sub_board)) && (line & blocked) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST_CASE("Testing PatternEvaluator") {
+  SECTION("Zero weights evaluate every state as even") {
+    PatternEvaluator evaluator;
+    std::vector<BitBoard> positions;
+    XorShiftRandom random(1);
+    PlayRandomGame(random, positions);
+    for (const BitBoard& board : positions) {
+      REQUIRE(evaluator.Evaluate(board) == 0);
+    }
+  }
+
+  SECTION("Patterns of corner sub-boards are transformed to the top left corner") {
+    BitBoard board;
+    board.PlayMove(0, 0);
+    board.PlayMove(0, 8);
+    board.PlayMove(8, 8);
+    size_t indices[PatternEvaluator::kNumActiveWeights];
+    PatternEvaluator::GetActiveWeights(board, indices);
+
+    // Player 2 is to move, so their mark in sub-board 0 is a 1 digit, and player 1's marks 2 digits.
+    size_t corner_table = 3 * PatternEvaluator::kNumPatterns;
+    REQUIRE(indices[0] == corner_table + 6561 + 2);
+    REQUIRE(indices[8] == corner_table + 2);
+    REQUIRE(indices[2] == corner_table);
+    REQUIRE(indices[1] == (4 + 3) * PatternEvaluator::kNumPatterns);
+    REQUIRE(indices[4] == (8 + 3) * PatternEvaluator::kNumPatterns);
+    REQUIRE(indices[BitBoard::kNumCells] == PatternEvaluator::kBiasWeight);
+  }
+
+  SECTION("Active weights match the position class, macro context, and marks of each sub-board") {
+    XorShiftRandom random(3);
+    std::vector<BitBoard> positions;
+    for (size_t game = 0; game < 50; game++) {
+      PlayRandomGame(random, positions);
+    }
+    size_t num_blocked_contexts = 0;
+    for (const BitBoard& board : positions) {
+      Player player = board.GetCurrentPlayer();
+      Player opponent = (player == Player::kPlayer1 ? Player::kPlayer2 : Player::kPlayer1);
+      size_t indices[PatternEvaluator::kNumActiveWeights];
+      PatternEvaluator::GetActiveWeights(board, indices);
+      for (size_t sub_board = 0; sub_board < BitBoard::kNumCells; sub_board++) {
+        size_t pattern = indices[sub_board] % PatternEvaluator::kNumPatterns;
+        size_t table = indices[sub_board] / PatternEvaluator::kNumPatterns;
+        size_t position_class = (sub_board == 4 ? 2 : sub_board % 2);
+        size_t context = (IsOnOpenLine(board, player, sub_board) ? 1 : 0) |
+                         (IsOnOpenLine(board, opponent, sub_board) ? 2 : 0);
+        REQUIRE(table == position_class * PatternEvaluator::kNumContexts + context);
+        if (context != 3) {
+          num_blocked_contexts++;
+        }
+
+        size_t counts[3] = {0, 0, 0};
+        for (size_t cell = 0; cell < BitBoard::kNumCells; cell++) {
+          counts[pattern % 3]++;
+          pattern /= 3;
+        }
+        REQUIRE(counts[1] == ultimate_tictactoe::PopCount(board.GetMarks(player, sub_board)));
+        REQUIRE(counts[2] == ultimate_tictactoe::PopCount(board.GetMarks(opponent, sub_board)));
+      }
+      REQUIRE(indices[BitBoard::kNumCells] == PatternEvaluator::kBiasWeight);
+    }
+    REQUIRE(num_blocked_contexts > 100);
+  }
+
+  SECTION("The value is tanh of the sum of the active weights") {
+    std::vector<float> weights = MakeRandomWeights(5);
+    PatternEvaluator evaluator;
+    evaluator.SetWeights(weights);
+    XorShiftRandom random(7);
+    std::vector<BitBoard> positions;
+    PlayRandomGame(random, positions);
+    for (const BitBoard& board : positions) {
+      size_t indices[PatternEvaluator::kNumActiveWeights];
+      PatternEvaluator::GetActiveWeights(board, indices);
+      double sum = 0;
+      for (size_t index : indices) {
+        sum += weights[index];
+      }
+      REQUIRE(evaluator.Evaluate(board) == tanh(sum));
+    }
+    REQUIRE_THROWS_AS(evaluator.SetWeights(std::vector<float>(10)), std::invalid_argument);
+  }
+
+  SECTION("Batches are evaluated exactly as their positions one at a time") {
+    PatternEvaluator evaluator;
+    evaluator.SetWeights(MakeRandomWeights(19));
+    XorShiftRandom random(21);
+    std::vector<BitBoard> positions;
+    PlayRandomGame(random, positions);
+    for (const BitBoard& board : positions) {
+      PositionBatch batch;
+      std::vector<BitBoard> children;
+      AddChildren(board, batch, children);
+      double values[PositionBatch::kMaxSize];
+      evaluator.EvaluateBatch(batch, values);
+      for (size_t i = 0; i < children.size(); i++) {
+        REQUIRE(values[i] == evaluator.Evaluate(children[i]));
+      }
+    }
+  }
+
+  SECTION("Searches, which evaluate the last level in batches, match a plain negamax search") {
+    std::vector<float> weights = MakeRandomWeights(23);
+    PatternEvaluator reference_evaluator;
+    reference_evaluator.SetWeights(weights);
+    XorShiftRandom random(25);
+    for (size_t game = 0; game < 4; game++) {
+      std::vector<BitBoard> positions;
+      std::vector<Action> moves = PlayRandomGame(random, positions);
+      size_t num_moves = std::min(moves.size() - 1, 10 + 10 * game);
+      SuperBoard super_board;
+      for (size_t i = 0; i < num_moves; i++) {
+        super_board.PlayMove(moves[i]);
+      }
+
+      BasicTreeSearchAI<PatternEvaluator> AI;
+      AI.GetEvaluator().SetWeights(weights);
+      AI.SetState(super_board);
+      for (size_t depth = 1; depth <= 4; depth++) {
+        double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, depth).second;
+        REQUIRE(value == Negamax(positions[num_moves], reference_evaluator, depth, 0));
+      }
+
+      // The stepped search evaluates leaves one at a time, and visits the same nodes, also when
+      // the endgame solver solves some of the leaves' parents' children.
+      for (size_t endgame_solver_threshold : {0, 30}) {
+        AI.SetEndgameSolverThreshold(endgame_solver_threshold);
+        AI.SetSearchDepth(4);
+        Action expected_move = AI.GetMove();
+        size_t expected_nodes = AI.GetSearchStats().nodes;
+        size_t expected_leaves = AI.GetSearchStats().leaf_evaluations;
+        AI.BeginSteppedSearch();
+        while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+        REQUIRE(AI.FinishSteppedSearch() == expected_move);
+        REQUIRE(AI.GetSearchStats().nodes == expected_nodes);
+        REQUIRE(AI.GetSearchStats().leaf_evaluations == expected_leaves);
+      }
+    }
+  }
+
+  SECTION("Searches from symmetric states search every action, since the evaluator is not symmetric") {
+    std::vector<float> weights = MakeRandomWeights(27);
+    PatternEvaluator reference_evaluator;
+    reference_evaluator.SetWeights(weights);
+    BasicTreeSearchAI<PatternEvaluator> AI;
+    AI.GetEvaluator().SetWeights(weights);
+    for (size_t depth = 1; depth <= 3; depth++) {
+      double value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue, TreeSearchAI::kWinValue, depth).second;
+      REQUIRE(value == Negamax(BitBoard(), reference_evaluator, depth, 0));
+    }
+    AI.SetSearchDepth(2);
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().symmetric_actions_skipped == 0);
+  }
+
+  SECTION("Weights are written to and loaded from files") {
+    std::vector<float> weights = MakeRandomWeights(9);
+    PatternEvaluator::Write(kWeightsPath, weights);
+    PatternEvaluator evaluator;
+    evaluator.Load(kWeightsPath);
+    REQUIRE(evaluator.GetWeights() == weights);
+
+    // The loaded weights can be searched with.
+    std::unique_ptr<ultimate_tictactoe::SearchAI> AI =
+        ultimate_tictactoe::MakeTreeSearchAI(ultimate_tictactoe::EvaluatorType::kPattern, kWeightsPath);
+    AI->SetSearchDepth(3);
+    Action move = AI->GetMove();
+    REQUIRE(BitBoard::SubBoardIndex(move) < BitBoard::kNumCells);
+    REQUIRE(BitBoard::CellIndex(move) < BitBoard::kNumCells);
+    std::remove(kWeightsPath.c_str());
+  }
+
+  SECTION("Invalid weight files are not loaded") {
+    PatternEvaluator evaluator;
+    REQUIRE_THROWS_AS(evaluator.Load("missing_pattern_evaluator_test.bin"), std::runtime_error);
+    {
+      std::ofstream file(kWeightsPath, std::ios::binary);
+      file << "not a weight file";
+    }
+    REQUIRE_THROWS_AS(evaluator.Load(kWeightsPath), std::runtime_error);
+    std::remove(kWeightsPath.c_str());
+    REQUIRE_THROWS_AS(ultimate_tictactoe::MakeTreeSearchAI(ultimate_tictactoe::EvaluatorType::kPattern, kWeightsPath),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(PatternEvaluator::Write(kWeightsPath, std::vector<float>(10)), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Testing PatternTrainer") {
+  SECTION("Fitting recovers the values of positions that some weights fit exactly") {
+    std::vector<float> weights = MakeRandomWeights(11);
+    PatternTrainer trainer(1, 0, 1);
+    XorShiftRandom random(13);
+    for (size_t game = 0; game < 100; game++) {
+      std::vector<BitBoard> positions;
+      PlayRandomGame(random, positions);
+      for (const BitBoard& board : positions) {
+        size_t indices[PatternEvaluator::kNumActiveWeights];
+        PatternEvaluator::GetActiveWeights(board, indices);
+        double sum = 0;
+        for (size_t index : indices) {
+          sum += weights[index];
+        }
+        trainer.AddPosition(board, sum);
+      }
+    }
+
+    std::vector<float> zero_weights(PatternEvaluator::kNumWeights, 0);
+    double initial_error = trainer.GetMeanSquaredError(zero_weights);
+    std::vector<float> fitted_weights = trainer.Fit(1e-6, 200);
+    REQUIRE(initial_error > 0.01);
+    REQUIRE(trainer.GetMeanSquaredError(fitted_weights) < initial_error * 1e-4);
+  }
+
+  SECTION("Patterns that were never seen keep zero weights") {
+    PatternTrainer trainer(1, 0, 1);
+    XorShiftRandom random(15);
+    std::vector<BitBoard> positions;
+    trainer.AddGame(PlayRandomGame(random, positions));
+    REQUIRE(trainer.GetNumPositions() == positions.size());
+    std::vector<float> weights = trainer.Fit(1, 50);
+
+    // A sub-board full of the opponent's marks never happens.
+    REQUIRE(weights[3 * PatternEvaluator::kNumPatterns + PatternEvaluator::kNumPatterns - 1] == 0);
+    REQUIRE(trainer.GetMeanSquaredError(weights) < trainer.GetMeanSquaredError(std::vector<float>(weights.size())));
+  }
+
+  SECTION("Game results are fitted to the atanh of their values") {
+    PatternTrainer trainer(1, 0, 1);
+    XorShiftRandom random(19);
+    std::vector<BitBoard> positions;
+    std::vector<Action> moves = PlayRandomGame(random, positions);
+    BitBoard board = positions.back();
+    board.PlayMove(BitBoard::SubBoardIndex(moves.back()), BitBoard::CellIndex(moves.back()));
+    REQUIRE(board.GetWinner() != WinState::kTie);
+    trainer.AddGame(moves);
+
+    // Every target is atanh(kWonGameValue) or its negative.
+    double target = atanh(PatternTrainer::kWonGameValue);
+    REQUIRE(trainer.GetMeanSquaredError(std::vector<float>(PatternEvaluator::kNumWeights)) ==
+            Approx(target * target));
+  }
+
+  SECTION("Self-play games are complete, vary, and do not depend on the number of threads") {
+    PatternTrainer trainer(1, 4, 1);
+    PatternTrainer threaded_trainer(1, 4, 3);
+    std::vector<std::vector<Action>> games = trainer.PlayGames(6, 17);
+    REQUIRE(threaded_trainer.PlayGames(6, 17) == games);
+    REQUIRE(games.size() == 6);
+    bool openings_vary = false;
+    for (const std::vector<Action>& game : games) {
+      threaded_trainer.AddGame(game);
+      openings_vary = openings_vary || !(game[0] == games[0][0]);
+    }
+    REQUIRE(openings_vary);
+
+    std::vector<float> weights = threaded_trainer.Fit(1, 50);
+    REQUIRE(threaded_trainer.GetMeanSquaredError(weights) <
+            threaded_trainer.GetMeanSquaredError(std::vector<float>(weights.size())));
+  }
+
+  SECTION("Invalid games are rejected") {
+    PatternTrainer trainer(1, 0, 1);
+    REQUIRE_THROWS_AS(PatternTrainer(0, 0, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(trainer.AddGame({BitBoard::ToAction(0, 0), BitBoard::ToAction(1, 1)}), std::invalid_argument);
+    REQUIRE_THROWS_AS(trainer.AddGame({BitBoard::ToAction(0, 0), BitBoard::ToAction(0, 1)}), std::invalid_argument);
+    REQUIRE(trainer.GetNumPositions() == 0);
+  }
+}
@@ -0,0 +1,203 @@
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <core/bitboard.h>
+#include <core/endgame_solver.h>
+#include <core/proof_number_search.h>
+#include <core/random_playout.h>
+#include <core/tree_search_ai.h>
+
+using ultimate_tictactoe::Action;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::EndgameSolution;
+using ultimate_tictactoe::EndgameSolver;
+using ultimate_tictactoe::ProofNumberSearch;
+using ultimate_tictactoe::ProofResult;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::TreeSearchAI;
+using ultimate_tictactoe::XorShiftRandom;
+
+namespace {
+
+// Plays the given number of random moves from the start of the game. Returns false if the game
+// ended before that.
+bool PlayRandomMoves(XorShiftRandom& random, size_t num_moves, SuperBoard& board) {
+  board = SuperBoard();
+  for (size_t i = 0; i < num_moves && !board.IsComplete(); i++) {
+    BitBoard bit_board(board);
+    board.PlayMove(bit_board.GetNthValidMove(random.NextBelow(bit_board.CountValidMoves())));
+  }
+  return !board.IsComplete();
+}
+
+// Returns true iff the player to move can force a win, according to the endgame solver.
+bool IsForcedWin(const SuperBoard& board) {
+  EndgameSolver solver(20, 100000000);
+  EndgameSolution solution;
+  REQUIRE(solver.Solve(BitBoard(board), solution));
+  return solution.outcome == 1;
+}
+
+}  // namespace
+
+TEST_CASE("Testing ProofNumberSearch") {
+  XorShiftRandom random(7);
+
+  SECTION("Results match the endgame solver") {
+    ProofNumberSearch search;
+    size_t num_positions = 0;
+    size_t num_proven = 0;
+    while (num_positions < 30) {
+      SuperBoard board;
+      if (!PlayRandomMoves(random, 50, board)) {
+        continue;
+      }
+      Action move = {0, 0, 0, 0};
+      ProofResult result = search.ProveWin(board, 1000000, move);
+      REQUIRE(result != ProofResult::kUnknown);
+      num_positions++;
+
+      REQUIRE((result == ProofResult::kProven) == IsForcedWin(board));
+      if (result == ProofResult::kProven) {
+        num_proven++;
+
+        // The first move of the proof either wins immediately, or leaves the opponent lost.
+        REQUIRE(board.IsValidMove(move));
+        board.PlayMove(move);
+        if (!board.IsComplete()) {
+          EndgameSolver solver(20, 100000000);
+          EndgameSolution solution;
+          REQUIRE(solver.Solve(BitBoard(board), solution));
+          REQUIRE(solution.outcome == -1);
+        }
+      }
+    }
+    REQUIRE(num_proven > 0);
+    REQUIRE(num_proven < num_positions);
+  }
+
+  SECTION("Searching gives up when the node budget runs out") {
+    SuperBoard board;
+    PlayRandomMoves(random, 10, board);
+    ProofNumberSearch search(10);
+    Action move = {0, 0, 0, 0};
+    REQUIRE(search.ProveWin(board, 100, move) == ProofResult::kUnknown);
+    REQUIRE(search.GetNodesSearched() == 100);
+  }
+
+  SECTION("Later searches reuse the table") {
+    SuperBoard board;
+    Action move = {0, 0, 0, 0};
+    ProofNumberSearch search;
+    // Wins that are proven immediately would not show the difference.
+    while (!PlayRandomMoves(random, 50, board) || search.ProveWin(board, 1000000, move) != ProofResult::kProven ||
+           search.GetNodesSearched() < 100) {}
+    size_t nodes = search.GetNodesSearched();
+    REQUIRE(search.ProveWin(board, 1000000, move) == ProofResult::kProven);
+    REQUIRE(search.GetNodesSearched() < nodes);
+
+    search.Clear();
+    REQUIRE(search.ProveWin(board, 1000000, move) == ProofResult::kProven);
+    REQUIRE(search.GetNodesSearched() == nodes);
+  }
+
+  SECTION("Complete games cannot be searched") {
+    SuperBoard board;
+    while (PlayRandomMoves(random, 81, board)) {}
+    ProofNumberSearch search;
+    Action move = {0, 0, 0, 0};
+    REQUIRE_THROWS_AS(search.ProveWin(board, 1000, move), std::runtime_error);
+  }
+}
+
+TEST_CASE("Testing TreeSearchAI's proof search") {
+  XorShiftRandom random(13);
+  SuperBoard board;
+  Action proof_move = {0, 0, 0, 0};
+  ProofNumberSearch search;
+  while (!PlayRandomMoves(random, 45, board) ||
+         search.ProveWin(board, TreeSearchAI::kSuggestedProofSearchNodes, proof_move) != ProofResult::kProven) {}
+
+  TreeSearchAI AI;
+  AI.SetState(board);
+  AI.SetSearchDepth(2);
+  AI.SetProofSearchNodes(TreeSearchAI::kSuggestedProofSearchNodes);
+
+  SECTION("Proven wins are played without searching") {
+    REQUIRE(AI.GetMove() == proof_move);
+    REQUIRE(AI.GetSearchStats().nodes == 0);
+    REQUIRE(AI.GetSearchStats().proof_search_nodes > 0);
+    REQUIRE(AI.GetPrincipalVariation() == std::vector<Action>(1, proof_move));
+  }
+
+  SECTION("Proven wins are played instead of pondered replies") {
+    // Ponders the position before one with a proven win, then plays the opponent's move into it.
+    SuperBoard previous_board;
+    Action opponent_move = {0, 0, 0, 0};
+    do {
+      while (!PlayRandomMoves(random, 44, previous_board)) {}
+      BitBoard bit_board(previous_board);
+      opponent_move = bit_board.GetNthValidMove(random.NextBelow(bit_board.CountValidMoves()));
+      board = previous_board;
+      board.PlayMove(opponent_move);
+    } while (board.IsComplete() ||
+             ProofNumberSearch().ProveWin(board, TreeSearchAI::kSuggestedProofSearchNodes, proof_move) !=
+                 ProofResult::kProven);
+
+    AI.SetState(previous_board);
+    AI.StartPondering();
+    while (AI.IsPondering()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    AI.UpdateState(opponent_move);
+    REQUIRE(AI.HasPonderedReply());
+    REQUIRE(AI.GetMove() == proof_move);
+    REQUIRE(AI.GetSearchStats().nodes == 0);
+    REQUIRE(AI.GetSearchStats().proof_search_nodes > 0);
+    REQUIRE_FALSE(AI.HasPonderedReply());
+  }
+
+  SECTION("Pondered replies are played when the proof search does not prove a win") {
+    AI.SetState(SuperBoard());
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartPondering();
+    while (AI.IsPondering()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    AI.UpdateState({0, 2, 1, 2});
+    REQUIRE(AI.HasPonderedReply());
+    TreeSearchAI reference_AI;
+    reference_AI.SetSearchDepth(2);
+    reference_AI.UpdateState({1, 2, 0, 2});
+    reference_AI.UpdateState({0, 2, 1, 2});
+    REQUIRE(AI.GetMove() == reference_AI.GetMove());
+    REQUIRE(AI.GetSearchStats().proof_search_nodes > 0);
+  }
+
+  SECTION("The stepped search plays proven wins like GetMove") {
+    Action move = AI.GetMove();
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    REQUIRE(AI.FinishSteppedSearch() == move);
+  }
+
+  SECTION("Proof searches that do not prove a win are counted in the search stats") {
+    AI.SetState(SuperBoard());
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().nodes > 0);
+    REQUIRE(AI.GetSearchStats().proof_search_nodes > 0);
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    AI.FinishSteppedSearch();
+    REQUIRE(AI.GetSearchStats().proof_search_nodes > 0);
+  }
+
+  SECTION("The proof search can be disabled") {
+    AI.SetProofSearchNodes(0);
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().nodes > 0);
+    REQUIRE(AI.GetSearchStats().proof_search_nodes == 0);
+  }
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+#include <core/random_playout.h>
+#include <core/superboard.h>
+
+using ultimate_tictactoe::RandomPlayout;
+using ultimate_tictactoe::XorShiftRandom;
+using ultimate_tictactoe::SuperBoard;
+using ultimate_tictactoe::BitBoard;
+using ultimate_tictactoe::WinState;
+
+TEST_CASE("Testing XorShiftRandom's NextBelow method") {
+  XorShiftRandom random(1);
+  size_t counts[9] = {0};
+  for (size_t i = 0; i < 9000; i++) {
+    size_t value = random.NextBelow(9);
+    REQUIRE(value < 9);
+    counts[value]++;
+  }
+
+  // Loose check that the values are roughly uniform.
+  for (size_t count : counts) {
+    REQUIRE(count > 800);
+    REQUIRE(count < 1200);
+  }
+}
+
+TEST_CASE("Testing RandomPlayout's Play method") {
+  SECTION("Playouts from the start of the game finish with a result") {
+    RandomPlayout playout;
+    for (size_t i = 0; i < 100; i++) {
+      REQUIRE(playout.Play(SuperBoard()) != WinState::kInProgress);
+    }
+    // Every game takes at least 17 moves (the shortest possible win).
+    REQUIRE(playout.GetMovesPlayed() >= 100 * 17);
+  }
+
+  SECTION("Playouts with the same seed are identical") {
+    RandomPlayout playout1(42);
+    RandomPlayout playout2(42);
+    for (size_t i = 0; i < 20; i++) {
+      REQUIRE(playout1.Play(SuperBoard()) == playout2.Play(SuperBoard()));
+    }
+    REQUIRE(playout1.GetMovesPlayed() == playout2.GetMovesPlayed());
+  }
+
+  SECTION("Playout from a complete game returns its winner without playing") {
+    SuperBoard board;
+    board.PlayMove({1, 2, 0, 2});
+    board.PlayMove({0, 2, 1, 2});
+    board.PlayMove({1, 2, 2, 2});
+    board.PlayMove({2, 2, 1, 2});
+    board.PlayMove({1, 2, 1, 2});
+    board.PlayMove({0, 0, 1, 1});
+    board.PlayMove({1, 1, 1, 0});
+    board.PlayMove({1, 0, 1, 1});
+    board.PlayMove({1, 1, 1, 2});
+    board.PlayMove({2, 0, 1, 1});
+    board.PlayMove({1, 1, 1, 1});
+    board.PlayMove({2, 1, 1, 0});
+    board.PlayMove({1, 0, 0, 0});
+    board.PlayMove({0, 0, 1, 0});
+    board.PlayMove({1, 0, 0, 1});
+    board.PlayMove({0, 1, 1, 0});
+    board.PlayMove({1, 0, 0, 2});
+
+    RandomPlayout playout;
+    REQUIRE(playout.Play(board) == WinState::kPlayer1Win);
+    REQUIRE(playout.GetMovesPlayed() == 0);
+  }
+
+  SECTION("Playouts do not modify the given position") {
+    SuperBoard board;
+    board.PlayMove({1, 2, 0, 2});
+    BitBoard bit_board(board);
+    RandomPlayout playout;
+    playout.Play(board);
+    playout.Play(bit_board);
+    REQUIRE(board.GetWinner() == WinState::kInProgress);
+    REQUIRE(bit_board.CountValidMoves() == 9);
+    REQUIRE(BitBoard(board).CountValidMoves() == 9);
+  }
+}
@@ -0,0 +1,59 @@
+#include <sstream>
+
+#include <catch2/catch.hpp>
+#include <core/search_stats.h>
+
+using ultimate_tictactoe::SearchStats;
+
+TEST_CASE("Testing SearchStats") {
+  SearchStats stats;
+  stats.Reset();
+
+  SECTION("Reset stats are all 0") {
+    REQUIRE(stats.nodes == 0);
+    REQUIRE(stats.nodes_per_ply.empty());
+    REQUIRE(stats.GetFirstMoveCutoffRate() == 0);
+    REQUIRE(stats.GetEffectiveBranchingFactor(0) == 0);
+    REQUIRE(stats.GetNodesPerSecond() == 0);
+    REQUIRE(stats.GetEvaluationCacheHitRate() == 0);
+  }
+
+  SECTION("Nodes are counted per ply") {
+    stats.RecordNode(0);
+    stats.RecordNode(1);
+    stats.RecordNode(1);
+    stats.RecordNode(1);
+    stats.RecordNode(2);
+    REQUIRE(stats.nodes == 5);
+    REQUIRE(stats.nodes_per_ply == std::vector<size_t>{1, 3, 1});
+    REQUIRE(stats.GetEffectiveBranchingFactor(0) == Approx(3));
+    REQUIRE(stats.GetEffectiveBranchingFactor(1) == Approx(1.0 / 3));
+    REQUIRE(stats.GetEffectiveBranchingFactor(2) == 0);
+
+    stats.elapsed_seconds = 0.5;
+    REQUIRE(stats.GetNodesPerSecond() == Approx(10));
+  }
+
+  SECTION("First move cutoff rate") {
+    stats.RecordCutoff(0);
+    stats.RecordCutoff(0);
+    stats.RecordCutoff(0);
+    stats.RecordCutoff(4);
+    REQUIRE(stats.beta_cutoffs == 4);
+    REQUIRE(stats.GetFirstMoveCutoffRate() == Approx(0.75));
+  }
+
+  SECTION("Evaluation cache hit rate") {
+    stats.eval_cache_probes = 8;
+    stats.eval_cache_hits = 2;
+    REQUIRE(stats.GetEvaluationCacheHitRate() == Approx(0.25));
+  }
+
+  SECTION("Stats can be logged") {
+    stats.RecordNode(0);
+    stats.RecordNode(1);
+    std::ostringstream log;
+    log << stats;
+    REQUIRE(log.str().find("nodes 2") != std::string::npos);
+  }
+}
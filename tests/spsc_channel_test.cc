@@ -0,0 +1,61 @@
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <core/spsc_channel.h>
+
+using ultimate_tictactoe::SpscChannel;
+
+TEST_CASE("Testing SpscChannel") {
+  SECTION("Values are popped in the order they were pushed") {
+    SpscChannel<int, 3> channel;
+    int value = 0;
+    REQUIRE_FALSE(channel.TryPop(value));
+    REQUIRE(channel.TryPush(1));
+    REQUIRE(channel.TryPush(2));
+    REQUIRE(channel.TryPop(value));
+    REQUIRE(value == 1);
+    REQUIRE(channel.TryPop(value));
+    REQUIRE(value == 2);
+    REQUIRE_FALSE(channel.TryPop(value));
+    REQUIRE(value == 2);
+  }
+
+  SECTION("Pushing to a full channel fails without blocking") {
+    SpscChannel<int, 2> channel;
+    REQUIRE(channel.TryPush(1));
+    REQUIRE(channel.TryPush(2));
+    REQUIRE_FALSE(channel.TryPush(3));
+
+    int value = 0;
+    REQUIRE(channel.TryPop(value));
+    REQUIRE(channel.TryPush(3));
+    REQUIRE(channel.TryPopLatest(value));
+    REQUIRE(value == 3);
+  }
+
+  SECTION("Values pass between threads in order") {
+    const int kNumValues = 100000;
+    SpscChannel<int, 16> channel;
+    std::thread producer([&channel, kNumValues]() {
+      for (int i = 0; i < kNumValues; i++) {
+        while (!channel.TryPush(i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    bool in_order = true;
+    int expected_value = 0;
+    while (expected_value < kNumValues) {
+      int value;
+      if (channel.TryPop(value)) {
+        in_order = in_order && (value == expected_value);
+        expected_value++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    producer.join();
+    REQUIRE(in_order);
+  }
+}
@@ -1,4 +1,5 @@
 #include <exception>
+#include <stdexcept>
 
 #include <catch2/catch.hpp>
 #include <core/superboard.h>
@@ -10,6 +11,32 @@ using ultimate_tictactoe::SubBoard;
 using ultimate_tictactoe::Player;
 using ultimate_tictactoe::WinState;
 using ultimate_tictactoe::Mark;
+using ultimate_tictactoe::Action;
+
+namespace {
+
+// Returns true iff a player can still win some row, column, or diagonal of sub-boards,
+// computed from scratch.
+bool HasWinnableLine(const SuperBoard& board) {
+  const size_t kLines[8][3][2] = {{{0, 0}, {0, 1}, {0, 2}}, {{1, 0}, {1, 1}, {1, 2}}, {{2, 0}, {2, 1}, {2, 2}},
+                                  {{0, 0}, {1, 0}, {2, 0}}, {{0, 1}, {1, 1}, {2, 1}}, {{0, 2}, {1, 2}, {2, 2}},
+                                  {{0, 0}, {1, 1}, {2, 2}}, {{0, 2}, {1, 1}, {2, 0}}};
+  for (const auto& line : kLines) {
+    bool player1_can_win = true;
+    bool player2_can_win = true;
+    for (const auto& sub_board : line) {
+      WinState winner = board.GetState()[sub_board[0]][sub_board[1]].GetWinner();
+      player1_can_win = player1_can_win && (winner == WinState::kInProgress || winner == WinState::kPlayer1Win);
+      player2_can_win = player2_can_win && (winner == WinState::kInProgress || winner == WinState::kPlayer2Win);
+    }
+    if (player1_can_win || player2_can_win) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
 
 TEST_CASE("Testing SuperBoard's PlayMove method") {
   SECTION("Play a move at start of game") {
@@ -509,4 +536,42 @@ TEST_CASE("Testing SuperBoard's IsValidMove method") {
       REQUIRE(board.IsValidMove({0, 0, 0, 0}));
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Testing SuperBoard's IsDeadDraw method") {
+  // The moves of the tied game in the GetWinner tests.
+  const Action kTiedGameMoves[] = {
+      {2, 0, 1, 2}, {1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2}, {1, 2, 1, 2},
+      {1, 0, 0, 2}, {0, 2, 2, 2}, {2, 2, 0, 0}, {0, 0, 1, 2}, {1, 1, 2, 2}, {2, 2, 2, 1},
+      {2, 1, 0, 0}, {0, 0, 0, 0}, {0, 0, 1, 1}, {1, 1, 1, 0}, {1, 0, 1, 2}, {1, 0, 1, 1},
+      {1, 1, 1, 2}, {0, 1, 1, 1}, {1, 1, 2, 1}, {2, 1, 1, 2}, {0, 2, 1, 0}, {1, 0, 2, 1},
+      {2, 1, 1, 1}, {1, 1, 0, 2}, {0, 2, 1, 1}, {1, 1, 2, 0}, {2, 0, 0, 1}, {0, 1, 0, 0},
+      {0, 0, 2, 1}, {2, 1, 0, 2}, {0, 1, 2, 0}, {2, 0, 1, 0}, {1, 0, 2, 2}, {2, 2, 0, 2},
+      {2, 2, 0, 1}, {0, 1, 2, 1}, {2, 1, 0, 1}, {0, 1, 2, 2}, {2, 2, 1, 0}, {1, 1, 0, 0},
+      {0, 0, 2, 0}, {2, 0, 2, 1}, {2, 1, 2, 1}, {2, 2, 1, 1}, {2, 2, 2, 2}, {2, 2, 2, 0},
+      {2, 0, 2, 0}, {2, 0, 0, 0}, {0, 0, 0, 1}, {2, 0, 1, 1}, {2, 0, 0, 2}, {2, 0, 2, 2}};
+
+  SECTION("No dead draw at start of game") {
+    SuperBoard board;
+    REQUIRE_FALSE(board.IsDeadDraw());
+  }
+
+  SECTION("Dead draws match a count of the winnable lines, when playing and reversing moves") {
+    SuperBoard board;
+    for (const Action& a : kTiedGameMoves) {
+      board.PlayMove(a);
+      REQUIRE(board.IsDeadDraw() == !HasWinnableLine(board));
+    }
+    REQUIRE(board.IsDeadDraw());
+
+    while (true) {
+      try {
+        board.ReverseAction();
+      } catch (const std::runtime_error&) {
+        break;
+      }
+      REQUIRE(board.IsDeadDraw() == !HasWinnableLine(board));
+    }
+    REQUIRE_FALSE(board.IsDeadDraw());
+  }
+}
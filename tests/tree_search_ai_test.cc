@@ -1,8 +1,14 @@
+#include <chrono>
 #include <exception>
+#include <memory>
+#include <sstream>
+#include <thread>
 
 #include <catch2/catch.hpp>
 #include <core/tree_search_ai.h>
 #include <core/action.h>
+#include <core/bitboard.h>
+#include <core/random_playout.h>
 
 using std::vector;
 using std::pair;
@@ -1052,4 +1058,542 @@ TEST_CASE("Test AI EvaluateStateWithSearch method") {
     REQUIRE(action_values.first == Action{2, 0, 0, 2});
     REQUIRE(action_values.second == Approx(tanh(-1.8 * AI.kRescalingFactor)).epsilon(0.001));
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test AI pondering") {
+  SECTION("Pondered reply matches the move found by searching") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(2);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartPondering();
+    while (AI.IsPondering()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    AI.UpdateState({0, 2, 1, 2});
+    REQUIRE(AI.HasPonderedReply());
+
+    TreeSearchAI reference_AI;
+    reference_AI.SetSearchDepth(2);
+    reference_AI.UpdateState({1, 2, 0, 2});
+    reference_AI.UpdateState({0, 2, 1, 2});
+    REQUIRE(AI.GetMove() == reference_AI.GetMove());
+    REQUIRE_FALSE(AI.HasPonderedReply());
+  }
+
+  SECTION("Stopping pondering early leaves the AI's state and moves unaffected") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(3);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartPondering();
+    AI.UpdateState({0, 2, 1, 2});
+
+    TreeSearchAI reference_AI;
+    reference_AI.SetSearchDepth(3);
+    reference_AI.UpdateState({1, 2, 0, 2});
+    reference_AI.UpdateState({0, 2, 1, 2});
+    REQUIRE(AI.GetMove() == reference_AI.GetMove());
+    REQUIRE(AI.EvaluateState() == Approx(reference_AI.EvaluateState()));
+  }
+
+  SECTION("Resetting the state discards pondered replies") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(1);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartPondering();
+    AI.ResetState();
+    REQUIRE_FALSE(AI.IsPondering());
+    REQUIRE_FALSE(AI.HasPonderedReply());
+  }
+}
+
+TEST_CASE("Test AI asynchronous search") {
+  SECTION("Finished search returns the same move as GetMove") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(2);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.UpdateState({0, 2, 1, 2});
+    AI.StartSearch();
+    Action move = AI.FinishSearch();
+    REQUIRE(AI.GetCompletedSearchDepth() == 2);
+    REQUIRE(AI.GetBestMoveSoFar() == move);
+    REQUIRE_FALSE(AI.IsSearching());
+    REQUIRE(move == AI.GetMove());
+  }
+
+  SECTION("Stopped search returns a valid move and leaves the state unchanged") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(20);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.StartSearch();
+    AI.RequestStop();
+    Action move = AI.FinishSearch();
+    REQUIRE(AI.GetCompletedSearchDepth() < 20);
+
+    SuperBoard board;
+    board.PlayMove({1, 2, 0, 2});
+    REQUIRE(board.IsValidMove(move));
+
+    TreeSearchAI reference_AI;
+    reference_AI.SetSearchDepth(1);
+    reference_AI.UpdateState({1, 2, 0, 2});
+    AI.SetSearchDepth(1);
+    REQUIRE(AI.GetMove() == reference_AI.GetMove());
+  }
+
+  SECTION("Search exceptions are rethrown by FinishSearch") {
+    TreeSearchAI AI;
+    REQUIRE_THROWS_AS(AI.FinishSearch(), std::logic_error);
+
+    AI.UpdateState({1, 2, 0, 2});
+    AI.UpdateState({0, 2, 1, 2});
+    AI.UpdateState({1, 2, 2, 2});
+    AI.UpdateState({2, 2, 1, 2});
+    AI.UpdateState({1, 2, 1, 2});
+    AI.UpdateState({0, 0, 1, 1});
+    AI.UpdateState({1, 1, 1, 0});
+    AI.UpdateState({1, 0, 1, 1});
+    AI.UpdateState({1, 1, 1, 2});
+    AI.UpdateState({2, 0, 1, 1});
+    AI.UpdateState({1, 1, 1, 1});
+    AI.UpdateState({2, 1, 1, 0});
+    AI.UpdateState({1, 0, 0, 0});
+    AI.UpdateState({0, 0, 1, 0});
+    AI.UpdateState({1, 0, 0, 1});
+    AI.UpdateState({0, 1, 1, 0});
+    AI.UpdateState({1, 0, 0, 2});
+    AI.StartSearch();
+    REQUIRE_THROWS_AS(AI.FinishSearch(), std::runtime_error);
+    REQUIRE_THROWS_AS(AI.GetBestMoveSoFar(), std::runtime_error);
+  }
+
+  SECTION("Updating the state cancels the search") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(20);
+    AI.StartSearch();
+    AI.UpdateState({1, 2, 0, 2});
+    REQUIRE_FALSE(AI.IsSearching());
+    REQUIRE(AI.IsSearchDone());
+  }
+}
+
+TEST_CASE("Test AI stepped search") {
+  const vector<Action> kMidGameMoves = {{2, 0, 1, 2}, {1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2},
+                                        {1, 2, 1, 2}, {1, 0, 0, 2}, {0, 2, 2, 2}, {2, 2, 0, 0}, {0, 0, 1, 2},
+                                        {1, 1, 2, 2}, {2, 2, 2, 1}, {2, 1, 0, 0}, {0, 0, 0, 0}, {0, 0, 1, 1},
+                                        {1, 1, 1, 0}, {1, 0, 1, 2}, {1, 0, 1, 1}};
+
+  SECTION("Stepped search returns the same moves as the recursive search") {
+    for (size_t num_moves : {0, 1, 6, 12, 18}) {
+      for (size_t depth = 1; depth <= 3; depth++) {
+        TreeSearchAI AI;
+        AI.SetSearchDepth(depth);
+        for (size_t i = 0; i < num_moves; i++) {
+          AI.UpdateState(kMidGameMoves[i]);
+        }
+        Action expected_move = AI.GetMove();
+
+        AI.BeginSteppedSearch();
+        while (!AI.StepSearch(std::chrono::milliseconds(0))) {
+          REQUIRE(AI.IsSteppedSearchRunning());
+        }
+        REQUIRE(AI.FinishSteppedSearch() == expected_move);
+        REQUIRE_FALSE(AI.IsSteppedSearchRunning());
+
+        // The stored state is back to where the search started
+        REQUIRE(AI.GetMove() == expected_move);
+      }
+    }
+  }
+
+  SECTION("Updating the state in the middle of a stepped search discards it") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(3);
+    AI.BeginSteppedSearch();
+    REQUIRE_FALSE(AI.StepSearch(std::chrono::milliseconds(0)));
+    AI.UpdateState({1, 2, 0, 2});
+    REQUIRE_FALSE(AI.IsSteppedSearchRunning());
+    REQUIRE_THROWS_AS(AI.FinishSteppedSearch(), std::logic_error);
+
+    TreeSearchAI reference_AI;
+    reference_AI.SetSearchDepth(3);
+    reference_AI.UpdateState({1, 2, 0, 2});
+    REQUIRE(AI.GetMove() == reference_AI.GetMove());
+  }
+
+  SECTION("Stepping without beginning a search throws") {
+    TreeSearchAI AI;
+    REQUIRE_THROWS_AS(AI.StepSearch(std::chrono::milliseconds(8)), std::logic_error);
+  }
+}
+
+TEST_CASE("Test AI search stats") {
+  SECTION("Depth 1 search from the start of the game") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(1);
+    AI.GetMove();
+    const ultimate_tictactoe::SearchStats& stats = AI.GetSearchStats();
+    // The empty board is symmetric, so only 15 of the 81 moves are distinct.
+    REQUIRE(stats.nodes == 16);
+    REQUIRE(stats.leaf_evaluations == 15);
+    REQUIRE(stats.symmetric_actions_skipped == 66);
+    REQUIRE(stats.terminal_hits == 0);
+    REQUIRE(stats.beta_cutoffs == 0);
+    REQUIRE(stats.GetEffectiveBranchingFactor(0) == Approx(15));
+  }
+
+  SECTION("Stepped search does the same work as the recursive search") {
+    TreeSearchAI AI;
+    AI.SetSearchDepth(3);
+    AI.UpdateState({1, 2, 0, 2});
+    AI.GetMove();
+    ultimate_tictactoe::SearchStats recursive_stats = AI.GetSearchStats();
+    REQUIRE(recursive_stats.beta_cutoffs > 0);
+
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    AI.FinishSteppedSearch();
+    const ultimate_tictactoe::SearchStats& stepped_stats = AI.GetSearchStats();
+    REQUIRE(stepped_stats.nodes == recursive_stats.nodes);
+    REQUIRE(stepped_stats.nodes_per_ply == recursive_stats.nodes_per_ply);
+    REQUIRE(stepped_stats.leaf_evaluations == recursive_stats.leaf_evaluations);
+    REQUIRE(stepped_stats.beta_cutoffs == recursive_stats.beta_cutoffs);
+    REQUIRE(stepped_stats.first_move_cutoffs == recursive_stats.first_move_cutoffs);
+  }
+
+  SECTION("Actions are ordered so that most cutoffs are caused by the first action") {
+    // Over a self-play game, since the ordering matters most once sub-boards fill up.
+    TreeSearchAI AI;
+    AI.SetSearchDepth(3);
+    SuperBoard board;
+    size_t beta_cutoffs = 0;
+    size_t first_move_cutoffs = 0;
+    for (size_t move_num = 0; move_num < 30 && !board.IsComplete() && !board.IsDeadDraw(); move_num++) {
+      AI.SetState(board);
+      board.PlayMove(AI.GetMove());
+      beta_cutoffs += AI.GetSearchStats().beta_cutoffs;
+      first_move_cutoffs += AI.GetSearchStats().first_move_cutoffs;
+    }
+    REQUIRE(first_move_cutoffs > 0.75 * beta_cutoffs);
+  }
+
+  SECTION("Stats are logged after each move when a log is set") {
+    std::ostringstream log;
+    TreeSearchAI AI;
+    AI.SetSearchDepth(1);
+    AI.SetSearchStatsLog(&log);
+    AI.GetMove();
+    REQUIRE(log.str().find("nodes 16") != std::string::npos);
+  }
+}
+
+TEST_CASE("Test AI EvaluateTopActions method") {
+  const vector<Action> kMidGameMoves = {{2, 0, 1, 2}, {1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2},
+                                        {1, 2, 1, 2}, {1, 0, 0, 2}, {0, 2, 2, 2}, {2, 2, 0, 0}, {0, 0, 1, 2},
+                                        {1, 1, 2, 2}, {2, 2, 2, 1}};
+  TreeSearchAI AI;
+  SuperBoard board;
+  for (const Action& a : kMidGameMoves) {
+    AI.UpdateState(a);
+    board.PlayMove(a);
+  }
+
+  SECTION("Best line matches GetMove") {
+    for (size_t depth = 1; depth <= 3; depth++) {
+      AI.SetSearchDepth(depth);
+      REQUIRE(AI.EvaluateTopActions(1, depth)[0].action == AI.GetMove());
+    }
+  }
+
+  SECTION("Values are exact and sorted, and principal variations are playable") {
+    const size_t kDepth = 3;
+    vector<ultimate_tictactoe::AnalysisLine> all_lines = AI.EvaluateTopActions(81, kDepth);
+    vector<ultimate_tictactoe::AnalysisLine> top_lines = AI.EvaluateTopActions(3, kDepth);
+    REQUIRE(top_lines.size() == 3);
+
+    for (size_t i = 0; i < all_lines.size(); i++) {
+      const ultimate_tictactoe::AnalysisLine& line = all_lines[i];
+      if (i > 0) {
+        REQUIRE(all_lines[i - 1].value >= line.value);
+      }
+      if (i < top_lines.size()) {
+        REQUIRE(top_lines[i].action == line.action);
+        REQUIRE(top_lines[i].value == Approx(line.value));
+        REQUIRE(top_lines[i].principal_variation == line.principal_variation);
+      }
+
+      // The value matches a full-window search of the action
+      AI.UpdateState(line.action);
+      double expected_value = -AI.EvaluateStateWithSearch(-1, 1, kDepth - 1).second;
+      AI.ResetState();
+      for (const Action& a : kMidGameMoves) {
+        AI.UpdateState(a);
+      }
+      REQUIRE(line.value == Approx(expected_value));
+
+      REQUIRE(line.principal_variation.size() <= kDepth);
+      REQUIRE(line.principal_variation[0] == line.action);
+      SuperBoard line_board = board;
+      for (const Action& a : line.principal_variation) {
+        REQUIRE(line_board.IsValidMove(a));
+        line_board.PlayMove(a);
+      }
+    }
+  }
+
+  SECTION("Invalid arguments throw") {
+    REQUIRE_THROWS_AS(AI.EvaluateTopActions(0, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(AI.EvaluateTopActions(2, 0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Test AI principal variation") {
+  const vector<Action> kMidGameMoves = {{2, 0, 1, 2}, {1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2},
+                                        {1, 2, 1, 2}, {1, 0, 0, 2}, {0, 2, 2, 2}, {2, 2, 0, 0}, {0, 0, 1, 2},
+                                        {1, 1, 2, 2}, {2, 2, 2, 1}};
+  const size_t kDepth = 4;
+  TreeSearchAI AI;
+  AI.SetSearchDepth(kDepth);
+  SuperBoard board;
+  for (const Action& a : kMidGameMoves) {
+    AI.UpdateState(a);
+    board.PlayMove(a);
+  }
+  REQUIRE(AI.GetPrincipalVariation().empty());
+
+  SECTION("GetMove's principal variation starts with the move and is playable") {
+    Action move = AI.GetMove();
+    vector<Action> principal_variation = AI.GetPrincipalVariation();
+    REQUIRE(principal_variation.size() == kDepth);
+    REQUIRE(principal_variation[0] == move);
+    for (const Action& a : principal_variation) {
+      REQUIRE(board.IsValidMove(a));
+      board.PlayMove(a);
+    }
+  }
+
+  SECTION("Stepped search finds the same principal variation") {
+    AI.GetMove();
+    vector<Action> principal_variation = AI.GetPrincipalVariation();
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    AI.FinishSteppedSearch();
+    REQUIRE(AI.GetPrincipalVariation() == principal_variation);
+  }
+
+  SECTION("Iterative deepening with principal variation ordering finds an equally good move") {
+    Action expected_move = AI.GetMove();
+    AI.StartSearch();
+    Action move = AI.FinishSearch();
+    REQUIRE(AI.GetCompletedSearchDepth() == kDepth);
+    REQUIRE(AI.GetPrincipalVariation().size() == kDepth);
+    REQUIRE(AI.GetPrincipalVariation()[0] == move);
+
+    AI.SetSearchDepth(kDepth - 1);
+    AI.UpdateState(expected_move);
+    double expected_value = -AI.EvaluateStateWithSearch(-1, 1, kDepth - 1).second;
+    AI.ResetState();
+    for (const Action& a : kMidGameMoves) {
+      AI.UpdateState(a);
+    }
+    AI.UpdateState(move);
+    REQUIRE(-AI.EvaluateStateWithSearch(-1, 1, kDepth - 1).second == Approx(expected_value));
+  }
+
+  SECTION("Updating the state clears the principal variation") {
+    AI.SetSearchDepth(1);
+    AI.UpdateState(AI.GetMove());
+    REQUIRE(AI.GetPrincipalVariation().empty());
+  }
+}
+
+TEST_CASE("Test AI dead draws") {
+  // Plays random games until one reaches a dead draw before it is complete.
+  ultimate_tictactoe::XorShiftRandom random(3);
+  SuperBoard board;
+  while (!board.IsDeadDraw() || board.IsComplete()) {
+    board = SuperBoard();
+    while (!board.IsComplete() && !board.IsDeadDraw()) {
+      ultimate_tictactoe::BitBoard bit_board(board);
+      board.PlayMove(bit_board.GetNthValidMove(random.NextBelow(bit_board.CountValidMoves())));
+    }
+  }
+
+  TreeSearchAI AI;
+  AI.SetState(board);
+
+  SECTION("Dead draws are scored as ties without searching further") {
+    pair<Action, double> action_and_value = AI.EvaluateStateWithSearch(-1, 1, 4);
+    REQUIRE(board.IsValidMove(action_and_value.first));
+    REQUIRE(action_and_value.second == 0);
+
+    // Every action leads to another dead draw, which is not searched.
+    REQUIRE(AI.GetSearchStats().nodes == 1 + ultimate_tictactoe::BitBoard(board).CountValidMoves());
+    REQUIRE(AI.GetSearchStats().terminal_hits == AI.GetSearchStats().nodes - 1);
+  }
+
+  SECTION("A move is still returned in a dead draw") {
+    AI.SetSearchDepth(3);
+    REQUIRE(board.IsValidMove(AI.GetMove()));
+  }
+}
+
+TEST_CASE("Test AI selective search") {
+  const vector<Action> kMidGameMoves = {{2, 0, 1, 2}, {1, 2, 0, 2}, {0, 2, 1, 2}, {1, 2, 2, 2}, {2, 2, 1, 2},
+                                        {1, 2, 1, 2}, {1, 0, 0, 2}, {0, 2, 2, 2}};
+  // Every technique enabled, with small margins so that each of them is used.
+  const ultimate_tictactoe::SelectiveSearchSettings kAllTechniques = {2, 2, 1, 2, 0.05, 3, 0.05};
+
+  SECTION("Disabled selective search is the full-width search") {
+    TreeSearchAI full_width_AI;
+    TreeSearchAI AI;
+    AI.SetSelectiveSearch(ultimate_tictactoe::SelectiveSearchSettings::Disabled());
+    for (const Action& a : kMidGameMoves) {
+      full_width_AI.UpdateState(a);
+      AI.UpdateState(a);
+    }
+    full_width_AI.SetSearchDepth(4);
+    AI.SetSearchDepth(4);
+    REQUIRE(AI.GetMove() == full_width_AI.GetMove());
+    REQUIRE(AI.GetSearchStats().nodes == full_width_AI.GetSearchStats().nodes);
+    REQUIRE(AI.GetSearchStats().late_move_reductions == 0);
+    REQUIRE(AI.GetSearchStats().futility_prunes == 0);
+    REQUIRE(AI.GetSearchStats().razorings == 0);
+  }
+
+  SECTION("Selective search returns valid moves with fewer nodes") {
+    for (const ultimate_tictactoe::SelectiveSearchSettings& settings :
+         {ultimate_tictactoe::SelectiveSearchSettings::Suggested(), kAllTechniques}) {
+      TreeSearchAI full_width_AI;
+      TreeSearchAI AI;
+      AI.SetSelectiveSearch(settings);
+      SuperBoard board;
+      for (const Action& a : kMidGameMoves) {
+        board.PlayMove(a);
+      }
+      full_width_AI.SetState(board);
+      AI.SetState(board);
+      full_width_AI.SetSearchDepth(5);
+      AI.SetSearchDepth(5);
+      full_width_AI.GetMove();
+      REQUIRE(board.IsValidMove(AI.GetMove()));
+      REQUIRE(AI.GetSearchStats().nodes < full_width_AI.GetSearchStats().nodes);
+      REQUIRE(AI.GetSearchStats().late_move_reductions > 0);
+      REQUIRE(AI.GetSearchStats().futility_prunes > 0);
+    }
+  }
+
+  SECTION("Every technique is used, and re-searches happen") {
+    TreeSearchAI AI;
+    AI.SetSelectiveSearch(kAllTechniques);
+    for (const Action& a : kMidGameMoves) {
+      AI.UpdateState(a);
+    }
+    AI.SetSearchDepth(5);
+    AI.GetMove();
+    REQUIRE(AI.GetSearchStats().late_move_researches > 0);
+    REQUIRE(AI.GetSearchStats().razorings > 0);
+  }
+
+  SECTION("Stepped search matches the recursive search") {
+    for (size_t num_moves : {0, 4, 8}) {
+      for (size_t depth = 1; depth <= 4; depth++) {
+        TreeSearchAI AI;
+        AI.SetSelectiveSearch(kAllTechniques);
+        AI.SetSearchDepth(depth);
+        for (size_t i = 0; i < num_moves; i++) {
+          AI.UpdateState(kMidGameMoves[i]);
+        }
+        Action expected_move = AI.GetMove();
+        ultimate_tictactoe::SearchStats recursive_stats = AI.GetSearchStats();
+
+        AI.BeginSteppedSearch();
+        while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+        REQUIRE(AI.FinishSteppedSearch() == expected_move);
+        const ultimate_tictactoe::SearchStats& stepped_stats = AI.GetSearchStats();
+        REQUIRE(stepped_stats.nodes == recursive_stats.nodes);
+        REQUIRE(stepped_stats.late_move_reductions == recursive_stats.late_move_reductions);
+        REQUIRE(stepped_stats.late_move_researches == recursive_stats.late_move_researches);
+        REQUIRE(stepped_stats.futility_prunes == recursive_stats.futility_prunes);
+        REQUIRE(stepped_stats.razorings == recursive_stats.razorings);
+      }
+    }
+  }
+}
+
+TEST_CASE("Test AI immediate wins and threats") {
+  // Plays random games until the player to move can win with their next move.
+  ultimate_tictactoe::XorShiftRandom random(5);
+  ultimate_tictactoe::BitBoard bit_board;
+  SuperBoard board;
+  size_t winning_sub_board;
+  size_t winning_cell;
+  while (!bit_board.FindWinningMove(winning_sub_board, winning_cell)) {
+    if (board.IsComplete() || board.IsDeadDraw()) {
+      board = SuperBoard();
+    }
+    bit_board = ultimate_tictactoe::BitBoard(board);
+    board.PlayMove(bit_board.GetNthValidMove(random.NextBelow(bit_board.CountValidMoves())));
+    bit_board = ultimate_tictactoe::BitBoard(board);
+  }
+
+  SECTION("An immediate win is returned without searching") {
+    TreeSearchAI AI;
+    AI.SetState(board);
+    pair<Action, double> action_and_value = AI.EvaluateStateWithSearch(-TreeSearchAI::kWinValue,
+                                                                       TreeSearchAI::kWinValue, 3);
+    REQUIRE(action_and_value.second == Approx(TreeSearchAI::kWinValue - TreeSearchAI::kWinDistanceStep));
+    REQUIRE(AI.GetSearchStats().nodes == 1);
+    REQUIRE(AI.GetSearchStats().immediate_wins == 1);
+
+    SuperBoard after_win = board;
+    after_win.PlayMove(action_and_value.first);
+    REQUIRE(after_win.GetWinner() == (board.GetCurrentPlayer() == ultimate_tictactoe::Player::kPlayer1
+                                          ? ultimate_tictactoe::WinState::kPlayer1Win
+                                          : ultimate_tictactoe::WinState::kPlayer2Win));
+  }
+
+  SECTION("Actions that let the opponent win are not searched, and the stepped search does the same") {
+    // The position before the winning chance, where the opponent was to move.
+    SuperBoard previous_board = board;
+    previous_board.ReverseAction();
+    TreeSearchAI AI;
+    AI.SetState(previous_board);
+    AI.SetSearchDepth(3);
+    Action expected_move = AI.GetMove();
+    ultimate_tictactoe::SearchStats recursive_stats = AI.GetSearchStats();
+    REQUIRE(recursive_stats.unsafe_actions_skipped > 0);
+
+    AI.BeginSteppedSearch();
+    while (!AI.StepSearch(std::chrono::milliseconds(1))) {}
+    REQUIRE(AI.FinishSteppedSearch() == expected_move);
+    REQUIRE(AI.GetSearchStats().nodes == recursive_stats.nodes);
+    REQUIRE(AI.GetSearchStats().immediate_wins == recursive_stats.immediate_wins);
+    REQUIRE(AI.GetSearchStats().unsafe_actions_skipped == recursive_stats.unsafe_actions_skipped);
+  }
+}
+
+TEST_CASE("Test AI evaluator choice") {
+  SECTION("The heuristic evaluator chosen at runtime plays the same moves as TreeSearchAI") {
+    std::unique_ptr<ultimate_tictactoe::SearchAI> AI =
+        ultimate_tictactoe::MakeTreeSearchAI(ultimate_tictactoe::EvaluatorType::kHeuristic);
+    TreeSearchAI reference_AI;
+    AI->SetSearchDepth(4);
+    reference_AI.SetSearchDepth(4);
+    for (size_t i = 0; i < 10; i++) {
+      Action move = AI->GetMove();
+      REQUIRE(move == reference_AI.GetMove());
+      AI->UpdateState(move);
+      reference_AI.UpdateState(move);
+    }
+  }
+
+  SECTION("Its stepped search is available through the interface") {
+    std::unique_ptr<ultimate_tictactoe::SearchAI> AI =
+        ultimate_tictactoe::MakeTreeSearchAI(ultimate_tictactoe::EvaluatorType::kHeuristic);
+    AI->SetSearchDepth(3);
+    Action expected_move = AI->GetMove();
+    AI->BeginSteppedSearch();
+    while (!AI->StepSearch(std::chrono::milliseconds(1))) {}
+    REQUIRE(AI->FinishSteppedSearch() == expected_move);
+  }
+}